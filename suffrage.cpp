@@ -43,7 +43,36 @@
  *                the boards as to how high of a prime they can take which can be
  *                found within the header file as "PRIME_THRESHOLD" and
  *                "PRIME_ARR_THRESHOLD" which is the prime sequence and the prime
- *                value plus one, respectively.  Change those for higher primes!
+ *                value plus one, respectively.  Anything past those (up to
+ *                "PRIME_SEGMENTED_THRESHOLD") is streamed through a fixed-size
+ *                segment buffer of "SEGMENT_WORDS" words.  Past that (up to
+ *                "PRIME_LEHMER_THRESHOLD", the last prime below 2^32) the
+ *                primes below an estimate of the answer are counted with
+ *                Meissel's formula and only the rest is sieved.
+ * >> cN,W      - same as cN for the workload W instead of the n_th prime:
+ *                0 = n_th prime, 1 = count of primes up to N, 2 = CRC-32 of N
+ *                generated bytes, 3 = N chained FNV-1a rounds, 4 = count of
+ *                primes up to N split across the grid.  The limits of each
+ *                are in the header file as "WORK_LIMIT_ARR".  For 4, the range
+ *                is cut into "PART_COUNT" parts, each counted by
+ *                "PART_REPLICAS" boards dealt out by the order of their IDs;
+ *                the counts are voted on part by part with (p)art packets and
+ *                every board votes for the sum of the parts' majorities.
+ * >> v         - request a CSV report of the last "CONV_SIZE" calculation
+ *                versions as seen by the local IXM:  how long its majority took
+ *                to settle, how many votes and nodes it saw, how many records
+ *                it received and sent, what the majority was and how long it
+ *                took to turn final against how long the last vote took (see
+ *                v_handler for the columns)
+ * >> s         - request a dump of the local IXM's counters (packets parsed
+ *                and rejected, duplicates, rate limited, forwards per face,
+ *                calculation and reflex time, ...) as "S" lines of CSV
+ * >> sN        - stream the counters every N ms out of the requesting face;
+ *                s0 stops the stream
+ * >> d         - drain the local IXM's trace of packet and vote events
+ *                (received, forwarded, duplicate, vote, majority change, strike,
+ *                reboot, ballot box retired, majority final) recorded since the
+ *                last drain, as "D" lines of CSV
  *
  * Notes:
  * The boards do not rely on a slave/master setup, meaning that every internal
@@ -51,6 +80,14 @@
  * have discordant data.  However, this setup also allows IXM's to have no single
  * point of failure should an arbitrary board encounter a data/network fault
  * (assuming grid with redundant networking paths).
+ * Calculations can be requested back to back:  the votes for the last
+ * "BALLOT_BOXES" versions before the current one keep being counted in ballot
+ * boxes of their own while each board works through them in order.  The boxes
+ * retire oldest first, once every active board voted or "BALLOT_TIMEOUT"
+ * passed, and the strikes are given out as they do.
+ * A majority is final as soon as the leader is ahead by more votes than there
+ * are boards left to vote:  later votes only count for the strikes, and the
+ * heartbeats back off without waiting for the stragglers.
  * As the amount of IXM's increase, data and networking redundancy increase:
  *  - 2+ boards allow a consensus to be made
  *  - 3+ boards allow an incorrect vote to be determined
@@ -91,6 +128,26 @@ setStatus(u32 STATUS)
   return;
 }
 
+/*
+ * Summary:     Records an event in the trace ring buffer, overwriting the
+ *              oldest one once it's full.  Only a handful of stores, so it can
+ *              stay on in the packet and vote paths.
+ * Parameters:  u8 kind of event (TRACE_*), u32 board ID, u32 value.
+ * Return:      None.
+ */
+void
+trace(u8 event, u32 id, u32 val)
+{
+  u32 i = TRACE_HEAD++ & (TRACE_SIZE - 1);
+
+  TRACE_TIME_ARR[i] = millis();
+  TRACE_EVENT_ARR[i] = event;
+  TRACE_ID_ARR[i] = id;
+  TRACE_VAL_ARR[i] = val;
+
+  return;
+}
+
 /*
  * Summary:     Clears out relevant variables arrays for a new calculation.
  * Parameters:  None.
@@ -101,110 +158,28 @@ flush()
 {
   // reinitialize the global variables
   MAJORITY_RSLT = 0;
+  MAJORITY_FINAL = false;
   CANDIDATE_COUNT = 0;
   VOTE_COUNT = 0;
+  TALLY_LEAD = INVALID;
+  TALLY_TOP = 0;
+  TALLY_NEXT = 0;
 
-  for (u32 i = 0; i < 32; ++i)
+  for (u32 i = 0; i < NODE_CAPACITY; ++i)
     { // and reinitialize the global arrays
       VOTE_NODE_ARR[i] = 0;
       CANDIDATE_ARR[i] = 0;
       CANDIDATE_VOTES_ARR[i] = 0;
     }
 
+  for (u32 h = 0; h < NODE_HASH_SIZE; ++h)
+    CANDIDATE_HASH_ARR[h] = 0;
+
   setStatus(OFF); // reset the LED as well
 
   return;
 }
 
-/*
- * Summary:     Given an array and a specific range [0, size) where the "size"_th
- *              iteration is not inclusive, return the iteration of the first
- *              instance of the specified key, or -1 if it does not exist.
- * Parameters:  u32 array to search, u32 size of the array, and the u32 element
- *              to locate.
- * Return:      Iteration of the first location of the key, -1 if it doesn't
- *              exist.
- */
-u32
-linearSearch(u32 a[], u32 size, u32 key)
-{
-  if (NULL == a) // null array pointer?
-    {
-      logNormal("linearSearch:  NULL array pointer!\n");
-      API_ASSERT_NONNULL(a); // blinkcode!
-    }
-
-  if (size <= 0) // invalid size?
-    {
-      logNormal("linearSearch:  Invalid size %d\n", size);
-      API_ASSERT_GREATER(size, 0); // blinkcode!
-    }
-
-  if (key < 0) // invalid key?
-    {
-      logNormal("linearSearch:  Invalid size %d\n", size);
-      API_ASSERT_GREATER_EQUAL(size, 0); // blinkcode!
-    }
-
-  for (u32 i = 0; i < size; ++i)
-    if (a[i] == key) // If there is a match
-      return i; // say so
-
-  return INVALID; // Otherwise, return the signal that there is no match
-}
-
-/*
- * Summary:     Given an array and a specific range [first, size) where the
- *              "size"_th iteration is not inclusive, return the index of the
- *              greatest positive value in the array or INVALID if there is a
- *              tie.
- * Parameters:  u32 array to search, u32 size of the array.
- * Return:      Index of the highest value greater than or equal to 0;
- *              INVALID otherwise.
- */
-u32
-getMaxIndex(u32 a[], u32 size)
-{
-  if (NULL == a) // null array pointer?
-    {
-      logNormal("getMaxIndex:  NULL array pointer!\n");
-      API_ASSERT_NONNULL(a); // blinkcode!
-    }
-
-  if (size <= 0) // invalid size?
-    {
-      logNormal("getMaxIndex:  Invalid size %d\n", size);
-      API_ASSERT_GREATER(size, 0); // blinkcode!
-    }
-
-  bool tiedetected = false; // flag to mark if there is a tie
-  u32 maxVotes = 0; // highest amount of ballots currently
-  u32 maxIndex = INVALID; // index of the highest candidate
-
-  for (u32 i = 0; i < size; ++i)
-    { // iterate through the entire array
-      if (a[i] > maxVotes)
-        { // record higher values
-          maxVotes = a[i];
-          maxIndex = i;
-          tiedetected = false; // disarm tie flag
-        }
-      // if there is ever candidate that ties with the highest candidate
-      else if (a[i] == maxVotes)
-        tiedetected = true; // set tie flag
-    }
-
-  if (tiedetected) // if the tie flag was set
-    return TIE; // there is no winning candidate
-
-  // It worked, there's a candidate greater than 0 votes and no ties
-  else if ((0 != maxVotes) && (INVALID != maxIndex))
-    return maxIndex;
-
-  else
-    return INVALID; // This should never happen.
-}
-
 /*
  * Summary:     Custom (c)alculation packet scanner.
  * Parameters:  The arguments are automatically handled within a parent
@@ -216,6 +191,7 @@ C_ZScanner(u8 * packet, void * arg, bool alt, int width)
 {
   /* (c)alculation packet structure */
   u32 CALC; // integer calculation
+  u32 WORK = WORK_PRIME; // workload, the n_th prime unless one follows
 
   if (packetScanf(packet, "%d", &CALC) != 1)
     {
@@ -224,10 +200,20 @@ C_ZScanner(u8 * packet, void * arg, bool alt, int width)
       return false;
     }
 
+  u32 n = packetScanf(packet, ",%d", &WORK); // 0 if no workload is given
+
+  if ((0 != n) && (2 != n))
+    {
+      logNormal("Inconsistent workload in (c)alculation packet.\n");
+
+      return false;
+    }
+
   if (arg)
     {
       C_PKT * PKT_R = (C_PKT*) arg;
       PKT_R->calc = CALC;
+      PKT_R->work = WORK;
     }
 
   return true;
@@ -291,381 +277,3355 @@ R_ZScanner(u8 * packet, void * arg, bool alt, int width)
 }
 
 /*
- * Summary:     Broadcasts the received packet to the neighboring nodes
- *              save for the terminal face if it is known.
- * Parameters:  (r)esult packet to be broadcasted.
+ * Summary:     Encodes an integer for a (b)inary packet as a little-endian
+ *              varint:  each character carries 5 bits of the value plus a
+ *              continuation bit, offset from WIRE_DIGIT so the packet stays
+ *              printable and can never contain a line break.
+ * Parameters:  char buffer to write to, u32 value.
+ * Return:      Count of characters written (1 to 7).
+ */
+u32
+wireEncode(char * buf, u32 v)
+{
+  u32 n = 0;
+
+  do
+    {
+      u32 digit = v & 0x1f;
+      v >>= 5;
+      buf[n++] = WIRE_DIGIT + (v ? (digit | 0x20) : digit);
+    }
+  while (v);
+
+  return n;
+}
+
+/*
+ * Summary:     Weighs a packet character into a (b)inary packet checksum.
+ *              Every character is weighed by its position so that swapped
+ *              characters are caught as well as corrupted ones.
+ * Parameters:  u32 running checksum, u32 position of the character, character.
+ * Return:      The updated checksum (10 bits).
+ */
+u32
+wireChecksum(u32 sum, u32 pos, u32 c)
+{
+  return (sum + (c * (pos + 1))) & 0x3ff;
+}
+
+/*
+ * Summary:     Custom (b)inary (r)esult packet printer.  The six fields are
+ *              written as varints (see wireEncode) followed by a two character
+ *              checksum.
+ * Parameters:  The arguments listed are automatically handled within a
+ *              parent header file.
  * Return:      None.
  */
 void
-BRD_R_PKT(struct R_PKT *PKT_T)
+R_BPrinter(u8 face, void * arg, bool alt, int width, bool zerofill)
 {
-  for (u32 i = 0; i < 4; ++i) // Forward received packet to neighboring nodes
-    if (TERMINAL_FACE != i) // but don't forward to the terminal face
-      facePrintf(i, "r%Z%z\n", R_ZPrinter, PKT_T);
+  API_ASSERT_NONNULL(arg);
+
+  R_PKT PKT_T = *(R_PKT*) arg;
+  u32 FIELDS[6] =
+    { PKT_T.key.ID, PKT_T.key.TIME, PKT_T.calc, PKT_T.calc_ver, PKT_T.rslt,
+        PKT_T.neighbor };
+  char buf[6 * 7 + 2 + 1]; // six varints, the checksum and a terminator
+  u32 n = 0;
+  u32 sum = 0;
+
+  for (u32 i = 0; i < 6; ++i)
+    n += wireEncode(buf + n, FIELDS[i]);
+
+  for (u32 i = 0; i < n; ++i)
+    sum = wireChecksum(sum, i, buf[i]);
+
+  buf[n++] = WIRE_DIGIT + (sum & 0x1f);
+  buf[n++] = WIRE_DIGIT + (sum >> 5);
+  buf[n] = '\0';
+
+  facePrintf(face, "%s", buf);
 
   return;
 }
 
 /*
- * Summary:     Forwards the received packet to the neighboring nodes
- *              save for the terminal face if known and the receiving face.
- * Parameters:  (r)esult packet to be forwarded.
+ * Summary:     Custom (b)inary (r)esult packet scanner.
+ * Parameters:  The arguments are automatically handled within a parent
+ *              header file.
+ * Return:      Boolean confirming the packet was read correctly.
+ */
+bool
+R_BScanner(u8 * packet, void * arg, bool alt, int width)
+{
+  /* (r)esult packet structure */
+  u32 FIELDS[6] =
+    { 0 }; // ID, TIME, CALC, CALC_VER, VOTE, NEIGHBOR
+  u32 pos = 0; // characters read so far
+  u32 sum = 0; // checksum of the characters read so far
+  u8 c;
+
+  for (u32 i = 0; i < 6; ++i)
+    {
+      for (u32 shift = 0;; shift += 5)
+        {
+          if ((shift > 30) || (packetScanf(packet, "%c", &c) != 1) || (c
+              < WIRE_DIGIT) || (c > (WIRE_DIGIT + 0x3f)))
+            {
+              logNormal("Inconsistent packet format for (b)inary packet.\n");
+              return false;
+            }
+
+          sum = wireChecksum(sum, pos++, c);
+          FIELDS[i] |= (u32) ((c - WIRE_DIGIT) & 0x1f) << shift;
+
+          if (!((c - WIRE_DIGIT) & 0x20)) // last character of the field
+            break;
+        }
+    }
+
+  u8 lo;
+  u8 hi;
+
+  if ((packetScanf(packet, "%c%c", &lo, &hi) != 2) || ((WIRE_DIGIT
+      + (sum & 0x1f)) != lo) || ((WIRE_DIGIT + (sum >> 5)) != hi))
+    {
+      logNormal("Checksum mismatch for (b)inary packet.\n");
+      return false;
+    }
+
+  if (arg)
+    {
+      R_PKT * PKT_R = (R_PKT*) arg;
+      PKT_R->key.ID = FIELDS[0];
+      PKT_R->key.TIME = FIELDS[1];
+      PKT_R->calc = FIELDS[2];
+      PKT_R->calc_ver = FIELDS[3];
+      PKT_R->rslt = FIELDS[4];
+      PKT_R->neighbor = FIELDS[5];
+    }
+
+  return true;
+}
+
+/*
+ * Summary:     Sends out the records queued on a face:  a lone record as a
+ *              plain (b)inary packet, more as one (m)ulti-record packet.
+ * Parameters:  u8 face.
  * Return:      None.
  */
 void
-FWD_R_PKT(struct R_PKT *PKT_T, u8 face)
+batchSend(u8 face)
 {
-  for (u32 i = 0; i < 4; ++i) // Forward received packet to neighboring nodes
-    if ((TERMINAL_FACE != i) && (face != i)) // that aren't the terminal or source face
-      facePrintf(i, "r%Z%z\n", R_ZPrinter, PKT_T);
+  if (1 == BATCH_COUNT_ARR[face])
+    facePrintf(face, "b%Z%z\n", R_BPrinter, &BATCH_ARR[face][0]);
+
+  else if (1 < BATCH_COUNT_ARR[face])
+    {
+      facePrintf(face, "m%c", WIRE_DIGIT + BATCH_COUNT_ARR[face]);
+
+      for (u32 i = 0; i < BATCH_COUNT_ARR[face]; ++i)
+        facePrintf(face, "%Z%z", R_BPrinter, &BATCH_ARR[face][i]);
+
+      facePrintf(face, "\n");
+    }
+
+  BATCH_COUNT_ARR[face] = 0;
 
   return;
 }
 
 /*
- * Summary:     Alarm to reboot a board
+ * Summary:     Sends out the records queued on every face once BATCH_WINDOW
+ *              is up.
  * Parameters:  Time when function was called (handled automagically).
  * Return:      None.
  */
 void
-reboot(u32 when)
+batchFlush(u32 when)
 {
   for (u32 i = 0; i < FACE_COUNT; ++i)
-    if (REBOOT_ARR[i])
-      {
-        powerOut(REBOOT_ARR[i], 1);
-        REBOOT_ARR[i] = 0;
-      }
+    batchSend(i);
 
   return;
 }
 
 /*
- * Summary:     Checks to see if the given node is a neighbor.
+ * Summary:     Queues a record on a face, so the burst of records that follows
+ *              a new calculation version leaves in few packets.  The queues go
+ *              out BATCH_WINDOW after the first record, or as soon as one
+ *              fills up.
+ * Parameters:  u8 face, (r)esult packet to be queued.
+ * Return:      None.
+ */
+void
+batchQueue(u8 face, struct R_PKT *PKT_T)
+{
+  bool idle = true; // whether nothing is queued on any face
+
+  for (u32 i = 0; i < FACE_COUNT; ++i)
+    if (0 != BATCH_COUNT_ARR[i])
+      idle = false;
+
+  if (idle) // the first record starts the window
+    Alarms.set(BATCH_ALARM, millis() + BATCH_WINDOW);
+
+  BATCH_ARR[face][BATCH_COUNT_ARR[face]++] = *PKT_T;
+
+  if (BATCH_MAX == BATCH_COUNT_ARR[face])
+    batchSend(face);
+
+  return;
+}
+
+/*
+ * Summary:     Sends a (r)esult packet out of a face, in the (b)inary encoding
+ *              if the neighbor on that face advertised it understands it and
+ *              in the text encoding otherwise (terminals, older sketches).
+ *              Packets that only tell the sender is alive go out as compact
+ *              (l)iveness packets to neighbors that understand those, and
+ *              full ones are batched for neighbors that understand (m)ulti-
+ *              record packets (unless BATCH_MODE is off).
+ * Parameters:  u8 face, (r)esult packet to be sent, bool whether the packet's
+ *              vote state is unchanged since its sender's last full packet.
+ * Return:      None.
+ */
+void
+sendR(u8 face, struct R_PKT *PKT_T, bool live)
+{
+  ++CONV_TX_ARR[CONV_HEAD]; // for the (v)ersion report
+
+  if (live && (FACE_CAPS_ARR[face] & WIRE_LIVENESS))
+    facePrintf(face, "l%t,%d,%d\n", PKT_T->key.ID, PKT_T->key.TIME,
+        PKT_T->neighbor);
+  else if (BATCH_MODE && (FACE_CAPS_ARR[face] & WIRE_BATCH)
+      && (FACE_CAPS_ARR[face] & WIRE_BINARY))
+    batchQueue(face, PKT_T);
+  else if (FACE_CAPS_ARR[face] & WIRE_BINARY)
+    facePrintf(face, "b%Z%z\n", R_BPrinter, PKT_T);
+  else
+    facePrintf(face, "r%Z%z\n", R_ZPrinter, PKT_T);
+
+  return;
+}
+
+/*
+ * Summary:     Hashes a board ID to its home slot in the node hash index.
  * Parameters:  u32 ID.
- * Return:      face, or INVALID if it's not a neighbor.
+ * Return:      Slot in NODE_HASH_ARR.
  */
 u32
-getNeighborFace(u32 id)
+nodeHash(u32 ID)
 {
-  for (u32 i = 0; i < FACE_COUNT; ++i) // Look through the array
-    if (id == NEIGHBORS_ARR[i]) // If we find a match
-      return i; // Say it's face
+  return (ID * 2654435761u) % NODE_HASH_SIZE; // Knuth's multiplicative hash
+}
 
-  return INVALID; // Otherwise, it's not a neighboring node
+/*
+ * Summary:     Looks up a board in the node table through the hash index.
+ *              The index is never more than a quarter full, so the linear
+ *              probe always ends at a free slot within a few steps.
+ * Parameters:  u32 ID.
+ * Return:      Index of the node, INVALID if the board isn't in the table.
+ */
+u32
+nodeFind(u32 ID)
+{
+  for (u32 h = nodeHash(ID); 0 != NODE_HASH_ARR[h]; h = (h + 1)
+      % NODE_HASH_SIZE)
+    if (ID == ID_NODE_ARR[NODE_HASH_ARR[h] - 1])
+      return NODE_HASH_ARR[h] - 1;
+
+  return INVALID;
 }
 
 /*
- * Summary:     Swiftly looks to see what IXM's have given an incorrect answer and
- *              updates the tables accordingly.
+ * Summary:     Adds a node of the node table to the hash index.
+ * Parameters:  u32 index of the node.
+ * Return:      None.
+ */
+void
+nodeIndex(u32 i)
+{
+  u32 h = nodeHash(ID_NODE_ARR[i]);
+
+  while (0 != NODE_HASH_ARR[h]) // probe for a free slot
+    h = (h + 1) % NODE_HASH_SIZE;
+
+  NODE_HASH_ARR[h] = i + 1;
+
+  return;
+}
+
+/*
+ * Summary:     Rebuilds the hash index from the node table, after nodes moved.
  * Parameters:  None.
  * Return:      None.
  */
 void
-strikeCheck()
+nodeReindex()
 {
-  u32 face;
+  for (u32 h = 0; h < NODE_HASH_SIZE; ++h)
+    NODE_HASH_ARR[h] = 0;
 
   for (u32 i = 0; i < NODE_COUNT; ++i)
-    {
-      if (VOTE_NODE_ARR[i] != MAJORITY_RSLT)
-        ++STRIKES_NODE_ARR[i];
-      else
-        STRIKES_NODE_ARR[i] = 0;
+    nodeIndex(i);
 
-      face = getNeighborFace(ID_NODE_ARR[i]);
+  return;
+}
 
-      if ((STRIKES_NODE_ARR[i] > 2) && (INVALID != face))
-        {
-          powerOut(face, 0);
-          REBOOT_ARR[face] = 1;
+/*
+ * Summary:     Looks up a ballot among the candidates through their hash index.
+ * Parameters:  u32 ballot.
+ * Return:      Index of the candidate, INVALID if nobody voted for it yet.
+ */
+u32
+candidateFind(u32 BALLOT)
+{
+  for (u32 h = nodeHash(BALLOT); 0 != CANDIDATE_HASH_ARR[h]; h = (h + 1)
+      % NODE_HASH_SIZE)
+    if (BALLOT == CANDIDATE_ARR[CANDIDATE_HASH_ARR[h] - 1])
+      return CANDIDATE_HASH_ARR[h] - 1;
 
-          Alarms.set(Alarms.create(reboot), millis() + reboot_PERIOD); // Set a reboot
-          return;
-        }
-    }
+  return INVALID;
 }
 
 /*
- * Summary:     Logs the ID and time-stamp keys of a received packet.
- * Parameters:  u32 ID, u32 time-stamp (from a (r)esult packet)
- * Return:      Return index of the node if successful, otherwise INVALID.
+ * Summary:     Adds a candidate to the candidate hash index.
+ * Parameters:  u32 index of the candidate.
+ * Return:      None.
  */
-u32
-log(u32 ID, u32 TIME)
+void
+candidateIndex(u32 k)
 {
-  if (TIME < 0)
-    {
-      logNormal("log:  No time-traveling or overflow allowed!\n");
-      API_ASSERT_GREATER_EQUAL(TIME, 0); // blinkcode!
-    }
+  u32 h = nodeHash(CANDIDATE_ARR[k]);
 
-  for (u32 i = 0; i < NODE_COUNT; ++i)
-    { // Look for an existing match in the list of previous PING'ers
-      if (ID == ID_NODE_ARR[i])
-        {
-          if (TIME != TS_NODE_ARR[i])
-            { // If there is a match and it is a new packet
-              if (PC_NODE_ARR[i] < 0xffff) // Make sure ping count won't overflow
-                ++PC_NODE_ARR[i]; // So we can keep track of the valid packet
-              else
-                // Notify us if the ping count will overflow
-                logNormal("Limit of pings reached for IXM %t\n", ID);
-
-              TS_NODE_ARR[i] = TIME; // Update nodular time-stamp
-              TS_HOST_ARR[i] = millis(); // Update host-based time-stamp
-
-              return i; // Return the location of the existing node
-            }
+  while (0 != CANDIDATE_HASH_ARR[h]) // probe for a free slot
+    h = (h + 1) % NODE_HASH_SIZE;
 
-          else
-            // Don't forward the packet if it isn't new
-            return INVALID;
-        }
-    }
+  CANDIDATE_HASH_ARR[h] = k + 1;
 
-  // Otherwise check to see if there is any free space left in the array
-  if (NODE_COUNT >= (sizeof(ID_NODE_ARR) / sizeof(u32)))
-    {
-      logNormal("Inadequate memory space in ID table.\n"
-        "Rebooting.\n");
-      reenterBootloader(); // Clear out memory for new boards
+  return;
+}
+
+/*
+ * Summary:     Counts a vote for a candidate and keeps the leader up to date.
+ *              Only the leader's count and the best count among the rest are
+ *              needed to tell a winner from a tie, and a single vote can only
+ *              raise one of them, so this is O(1).
+ * Parameters:  u32 index of the candidate.
+ * Return:      None.
+ */
+void
+tallyAdd(u32 k)
+{
+  u32 v = ++CANDIDATE_VOTES_ARR[k];
+
+  if (k == TALLY_LEAD) // the leader pulls further ahead
+    TALLY_TOP = v;
+
+  else if (v > TALLY_TOP)
+    { // a new leader; the old one becomes the best of the rest
+      TALLY_NEXT = TALLY_TOP;
+      TALLY_TOP = v;
+      TALLY_LEAD = k;
     }
 
-  // Add the new IXM board to the phone-book.
-  ID_NODE_ARR[NODE_COUNT] = ID;
-  TS_NODE_ARR[NODE_COUNT] = TIME;
-  TS_HOST_ARR[NODE_COUNT] = millis();
-  ++PC_NODE_ARR[NODE_COUNT];
+  else if (v > TALLY_NEXT) // catching up, possibly to a tie
+    TALLY_NEXT = v;
 
-  return NODE_COUNT++; // And pass it on
+  return;
 }
 
 /*
- * Summary:     Evaluates the votes for all of the candidates and changes the
- *              RESULT (global variable for majority) appropriately.
+ * Summary:     Recounts the leader from scratch, for when votes are taken back.
  * Parameters:  None.
  * Return:      None.
  */
 void
-evalMajority()
+tallyRescan()
 {
-  if (VOTE_COUNT >= VOTE_COUNT_MIN) // If there are at least 2 active nodes
+  TALLY_LEAD = INVALID;
+  TALLY_TOP = 0;
+  TALLY_NEXT = 0;
+
+  for (u32 k = 0; k < CANDIDATE_COUNT; ++k)
     {
-      if (0 == HOST_CALC) // Consider 0 an invalid calculation
+      if (CANDIDATE_VOTES_ARR[k] > TALLY_TOP)
         {
-          flush(); // and reset everything
-          return;
+          TALLY_NEXT = TALLY_TOP;
+          TALLY_TOP = CANDIDATE_VOTES_ARR[k];
+          TALLY_LEAD = k;
         }
 
-      // Look to see the location of the candidate with the most votes
-      u32 j = getMaxIndex(CANDIDATE_VOTES_ARR, (CANDIDATE_COUNT + 1));
+      else if (CANDIDATE_VOTES_ARR[k] > TALLY_NEXT)
+        TALLY_NEXT = CANDIDATE_VOTES_ARR[k];
+    }
 
-      if (TIE == j) // turn off the LED's in a tie-case
-        {
-          MAJORITY_RSLT = TIE; // set the tie as an indicator
-          setStatus(OFF);
-          return;
-        }
+  return;
+}
 
-      else // if there was no tie
-        {
-          MAJORITY_RSLT = CANDIDATE_ARR[j]; // set majority accordingly
-          setStatus((VOTE_NODE_ARR[0] == CANDIDATE_ARR[j]) ? MAJORITY
-              : MINORITY); // set host LED based off of agreement.
-          return;
-        }
-    }
+void
+evalMajority(); // evicted nodes' votes are retracted through it
 
+void
+boxRetract(u32 b, u32 NODE_INDEX); // and out of the ballot boxes through these
+
+void
+boxTally(u32 b);
+
+/*
+ * Summary:     Makes room in a full node table by evicting the node that has
+ *              been idle the longest.  Its vote is retracted, the last node
+ *              moves into its place and the hash index is rebuilt.  The host
+ *              and active nodes are never evicted.
+ * Parameters:  None.
+ * Return:      Index freed up (always NODE_COUNT afterwards), INVALID if every
+ *              node is active.
+ */
+u32
+nodeEvict()
+{
+  u32 j = INVALID; // the longest idle node
+
+  for (u32 i = 1; i < NODE_COUNT; ++i)
+    if (((millis() - TS_HOST_ARR[i]) >= IDLE_TIMEOUT) && ((INVALID == j)
+        || ((millis() - TS_HOST_ARR[i]) > (millis() - TS_HOST_ARR[j]))))
+      j = i;
+
+  if (INVALID == j)
+    return INVALID;
+
+  logNormal("Evicting idle IXM %t\n", ID_NODE_ARR[j]);
+
+  u32 k = candidateFind(VOTE_NODE_ARR[j]);
+
+  if ((0 != VOTE_NODE_ARR[j]) && MAJORITY_FINAL)
+    --VOTE_COUNT; // the tally is done with, see voteCount
+
+  else if ((0 != VOTE_NODE_ARR[j]) && (INVALID != k))
+    { // take back the evicted node's vote
+      --VOTE_COUNT;
+
+      if (0 == --CANDIDATE_VOTES_ARR[k])
+        { // nobody is left voting for it, so move the last candidate over it
+          u32 last = --CANDIDATE_COUNT;
+
+          CANDIDATE_ARR[k] = CANDIDATE_ARR[last];
+          CANDIDATE_VOTES_ARR[k] = CANDIDATE_VOTES_ARR[last];
+          CANDIDATE_ARR[last] = 0;
+          CANDIDATE_VOTES_ARR[last] = 0;
+
+          for (u32 h = 0; h < NODE_HASH_SIZE; ++h)
+            CANDIDATE_HASH_ARR[h] = 0;
+
+          for (u32 c = 0; c < CANDIDATE_COUNT; ++c)
+            candidateIndex(c);
+        }
+
+      tallyRescan();
+    }
+
+  for (u32 b = 0; b < BALLOT_BOXES; ++b)
+    if (0 != BOX_VER_ARR[b])
+      boxRetract(b, j); // in the older versions too
+
+  u32 last = --NODE_COUNT; // move the last node into the freed up place
+
+  ACTIVE_NODE_ARR[j] = ACTIVE_NODE_ARR[last];
+  PC_NODE_ARR[j] = PC_NODE_ARR[last];
+  ID_NODE_ARR[j] = ID_NODE_ARR[last];
+  VOTE_NODE_ARR[j] = VOTE_NODE_ARR[last];
+  TS_HOST_ARR[j] = TS_HOST_ARR[last];
+  TS_NODE_ARR[j] = TS_NODE_ARR[last];
+  SEEN_HEAD_ARR[j] = SEEN_HEAD_ARR[last];
+  STRIKES_NODE_ARR[j] = STRIKES_NODE_ARR[last];
+  BUCKET_NODE_ARR[j] = BUCKET_NODE_ARR[last];
+  BUCKET_TS_NODE_ARR[j] = BUCKET_TS_NODE_ARR[last];
+  CALC_NODE_ARR[j] = CALC_NODE_ARR[last];
+  VER_NODE_ARR[j] = VER_NODE_ARR[last];
+  RSLT_NODE_ARR[j] = RSLT_NODE_ARR[last];
+
+  for (u32 w = 0; w < SEEN_WINDOW; ++w)
+    SEEN_NODE_ARR[j][w] = SEEN_NODE_ARR[last][w];
+
+  for (u32 b = 0; b < BALLOT_BOXES; ++b)
+    {
+      BOX_VOTE_ARR[b][j] = BOX_VOTE_ARR[b][last];
+      BOX_VOTE_ARR[b][last] = 0;
+    }
+
+  ACTIVE_NODE_ARR[last] = 'I'; // and clear out the last place
+  PC_NODE_ARR[last] = 0;
+  ID_NODE_ARR[last] = 0;
+  VOTE_NODE_ARR[last] = 0;
+  SEEN_HEAD_ARR[last] = 0;
+  STRIKES_NODE_ARR[last] = 0;
+  BUCKET_NODE_ARR[last] = 0;
+  BUCKET_TS_NODE_ARR[last] = 0;
+  CALC_NODE_ARR[last] = 0;
+  VER_NODE_ARR[last] = 0;
+  RSLT_NODE_ARR[last] = 0;
+
+  nodeReindex();
+  evalMajority(); // the majority may have changed without the vote
+
+  for (u32 b = 0; b < BALLOT_BOXES; ++b)
+    if ((0 != BOX_VER_ARR[b]) && !BOX_FINAL_ARR[b])
+      boxTally(b); // in the older versions too
+
+  return last;
+}
+
+/*
+ * Summary:     Checks whether the neighbor on a face took part in the spanning
+ *              tree recently, i.e. sent a (n)eighbor packet within TREE_TIMEOUT
+ *              (scaled like IDLE_TIMEOUT for backed-off heartbeats).
+ * Parameters:  u32 face.
+ * Return:      True if the face's tree information is current.
+ */
+bool
+treeFresh(u32 face)
+{
+  return (0 != TREE_TS_ARR[face]) && ((millis() - TREE_TS_ARR[face])
+      < (TREE_TIMEOUT * BEAT_STABLE / pingAll_PERIOD));
+}
+
+/*
+ * Summary:     Checks whether a board may serve as the spanning tree root:  the
+ *              host, or a node that was heard from within IDLE_TIMEOUT.  Refusing
+ *              roots that went quiet keeps stale roots from bouncing between
+ *              boards with ever-growing hop counts once the real root is gone.
+ * Parameters:  u32 ID.
+ * Return:      True if the board is alive as far as the host knows.
+ */
+bool
+treeAlive(u32 id)
+{
+  if (ID_HOST == id)
+    return true;
+
+  u32 i = nodeFind(id);
+
+  return (INVALID != i) && ((millis() - TS_HOST_ARR[i]) < IDLE_TIMEOUT);
+}
+
+/*
+ * Summary:     Recomputes the host's place in the spanning tree from what the
+ *              neighbors last advertised.  The root is the lowest live board ID
+ *              and the parent is the neighbor closest to it (ties go to the
+ *              lowest neighbor ID), so every board settles on the same tree.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+treeUpdate()
+{
+  TREE_ROOT = ID_HOST; // until a neighbor knows better, the host is root
+  TREE_HOPS = 0;
+  TREE_PARENT = INVALID;
+
+  for (u32 i = 0; i < FACE_COUNT; ++i)
+    {
+      if (!treeFresh(i) || TREE_CHILD_ARR[i] || !treeAlive(TREE_ROOT_ARR[i]))
+        continue; // the neighbor is gone, hangs off the host, or is lost
+
+      if ((TREE_ROOT_ARR[i] < TREE_ROOT) || ((TREE_ROOT_ARR[i] == TREE_ROOT)
+          && ((TREE_HOPS_ARR[i] + 1) < TREE_HOPS)) || ((TREE_ROOT_ARR[i]
+          == TREE_ROOT) && ((TREE_HOPS_ARR[i] + 1) == TREE_HOPS)
+          && (INVALID != TREE_PARENT) && (NEIGHBORS_ARR[i]
+          < NEIGHBORS_ARR[TREE_PARENT])))
+        { // a better way to the root
+          TREE_ROOT = TREE_ROOT_ARR[i];
+          TREE_HOPS = TREE_HOPS_ARR[i] + 1;
+          TREE_PARENT = i;
+        }
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Decides whether (r)esult packets go out of a face.  With
+ *              TREE_ROUTING, faces whose neighbor takes part in the tree only
+ *              get packets if they are tree links (the parent or a child);
+ *              every other face is flooded as usual, so neighbors that don't
+ *              take part in the tree, or are still in another one, hear
+ *              everything (and so learn of the host's root).
+ * Parameters:  u32 face.
+ * Return:      True if packets should be sent out of the face.
+ */
+bool
+treeFace(u32 face)
+{
+  if (!TREE_ROUTING || !treeFresh(face) || (TREE_ROOT_ARR[face] != TREE_ROOT))
+    return true; // also flood neighbors that haven't joined the host's tree
+
+  return (TREE_PARENT == face) || TREE_CHILD_ARR[face];
+}
+
+/*
+ * Summary:     Sends a (n)eighbor packet advertising the host's place in the
+ *              spanning tree out of every face but the terminal's.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+treeAnnounce()
+{
+  treeUpdate();
+
+  u32 parent = (INVALID == TREE_PARENT) ? ID_HOST : NEIGHBORS_ARR[TREE_PARENT];
+
+  for (u32 i = 0; i < FACE_COUNT; ++i)
+    if (TERMINAL_FACE != i)
+      facePrintf(i, "n%t,%t,%d,%t\n", ID_HOST, TREE_ROOT, TREE_HOPS, parent);
+
+  return;
+}
+
+/*
+ * Summary:     Broadcasts the received packet to the neighboring nodes
+ *              save for the terminal face if it is known.
+ * Parameters:  (r)esult packet to be broadcasted, bool whether it only tells
+ *              that its sender is alive (see sendR).
+ * Return:      None.
+ */
+void
+BRD_R_PKT(struct R_PKT *PKT_T, bool live)
+{
+  for (u32 i = 0; i < 4; ++i) // Forward received packet to neighboring nodes
+    if ((TERMINAL_FACE != i) && treeFace(i)) // but don't forward to the terminal face
+      sendR(i, PKT_T, live);
+
+  return;
+}
+
+/*
+ * Summary:     Forwards the received packet to the neighboring nodes
+ *              save for the terminal face if known and the receiving face.
+ * Parameters:  (r)esult packet to be forwarded, u8 face it came from, bool
+ *              whether it only tells that its sender is alive (see sendR).
+ * Return:      None.
+ */
+void
+FWD_R_PKT(struct R_PKT *PKT_T, u8 face, bool live)
+{
+  trace(TRACE_FWD, PKT_T->key.ID, PKT_T->key.TIME);
+
+  for (u32 i = 0; i < 4; ++i) // Forward received packet to neighboring nodes
+    if ((TERMINAL_FACE != i) && (face != i) && treeFace(i)) // that aren't the terminal or source face
+      {
+        sendR(i, PKT_T, live);
+        ++FWD_FACE_ARR[i];
+      }
+
+  return;
+}
+
+/*
+ * Summary:     Alarm to reboot a board
+ * Parameters:  Time when function was called (handled automagically).
+ * Return:      None.
+ */
+void
+reboot(u32 when)
+{
+  for (u32 i = 0; i < FACE_COUNT; ++i)
+    if (REBOOT_ARR[i])
+      {
+        powerOut(REBOOT_ARR[i], 1);
+        REBOOT_ARR[i] = 0;
+      }
+
+  return;
+}
+
+/*
+ * Summary:     Checks to see if the given node is a neighbor.
+ * Parameters:  u32 ID.
+ * Return:      face, or INVALID if it's not a neighbor.
+ */
+u32
+getNeighborFace(u32 id)
+{
+  for (u32 i = 0; i < FACE_COUNT; ++i) // Look through the array
+    if (id == NEIGHBORS_ARR[i]) // If we find a match
+      return i; // Say it's face
+
+  return INVALID; // Otherwise, it's not a neighboring node
+}
+
+/*
+ * Summary:     Swiftly looks to see what IXM's have given an incorrect answer and
+ *              updates the tables accordingly.
+ * Parameters:  u32 ballots of the respective nodes, u32 majority result they
+ *              are held against.
+ * Return:      None.
+ */
+void
+strikeCheck(const u32 * votes, u32 majority)
+{
+  u32 face;
+
+  for (u32 i = 0; i < NODE_COUNT; ++i)
+    {
+      if (votes[i] != majority)
+        trace(TRACE_STRIKE, ID_NODE_ARR[i], ++STRIKES_NODE_ARR[i]);
+      else
+        STRIKES_NODE_ARR[i] = 0;
+
+      face = getNeighborFace(ID_NODE_ARR[i]);
+
+      if ((STRIKES_NODE_ARR[i] > 2) && (INVALID != face))
+        {
+          trace(TRACE_REBOOT, ID_NODE_ARR[i], face);
+          powerOut(face, 0);
+          REBOOT_ARR[face] = 1;
+
+          Alarms.set(Alarms.create(reboot), millis() + reboot_PERIOD); // Set a reboot
+          return;
+        }
+    }
+}
+
+/*
+ * Summary:     Remembers a packet time-stamp in a node's seen-window, and as
+ *              the node's newest time-stamp if it is.
+ * Parameters:  u32 index of the node, u32 time-stamp.
+ * Return:      None.
+ */
+void
+seenRecord(u32 i, u32 TIME)
+{
+  SEEN_NODE_ARR[i][SEEN_HEAD_ARR[i]] = TIME; // overwrite the oldest
+  SEEN_HEAD_ARR[i] = (SEEN_HEAD_ARR[i] + 1) % SEEN_WINDOW;
+
+  if ((s32) (TIME - TS_NODE_ARR[i]) > 0) // newer than anything so far
+    TS_NODE_ARR[i] = TIME;
+
+  return;
+}
+
+/*
+ * Summary:     Decides whether a packet from a known node has been seen before.
+ *              Packets that are in the node's seen-window are duplicates, and
+ *              packets older than the whole window are stale; neither is worth
+ *              forwarding.  A time-stamp far behind the newest one means the
+ *              node restarted, so its window starts over.  Time-stamps are
+ *              compared by difference so millis() rolling over is harmless.
+ * Parameters:  u32 index of the node, u32 time-stamp.
+ * Return:      True if the packet should be suppressed.
+ */
+bool
+seenCheck(u32 i, u32 TIME)
+{
+  s32 age = (s32) (TS_NODE_ARR[i] - TIME); // how far behind the newest it is
+
+  if (age > (s32) IDLE)
+    { // the node restarted, forget its old time-stamps
+      for (u32 w = 0; w < SEEN_WINDOW; ++w)
+        SEEN_NODE_ARR[i][w] = TIME;
+
+      TS_NODE_ARR[i] = TIME;
+      return false;
+    }
+
+  for (u32 w = 0; w < SEEN_WINDOW; ++w)
+    if (TIME == SEEN_NODE_ARR[i][w]) // seen it already
+      return true;
+
+  // older than the oldest time-stamp in the window
+  if ((age > 0) && (age > (s32) (TS_NODE_ARR[i]
+      - SEEN_NODE_ARR[i][SEEN_HEAD_ARR[i]])))
+    return true;
+
+  return false;
+}
+
+/*
+ * Summary:     Tells duplicates apart for the senders the node table has no
+ *              room for, from a small ring of their recent records.  Records
+ *              pushed out of the ring may come through again, but their
+ *              faces' rate limits keep that in check.
+ * Parameters:  u32 ID, u32 time-stamp (from a (r)esult packet)
+ * Return:      True if the record was seen already, otherwise it's remembered.
+ */
+bool
+overflowSeen(u32 ID, u32 TIME)
+{
+  for (u32 i = 0; i < OVERFLOW_SIZE; ++i)
+    if ((ID == OVERFLOW_ID_ARR[i]) && (TIME == OVERFLOW_TIME_ARR[i]))
+      return true;
+
+  OVERFLOW_ID_ARR[OVERFLOW_HEAD] = ID;
+  OVERFLOW_TIME_ARR[OVERFLOW_HEAD] = TIME;
+  OVERFLOW_HEAD = (OVERFLOW_HEAD + 1) % OVERFLOW_SIZE;
+
+  return false;
+}
+
+/*
+ * Summary:     Logs the ID and time-stamp keys of a received packet.
+ * Parameters:  u32 ID, u32 time-stamp (from a (r)esult packet)
+ * Return:      Return index of the node if successful, TABLE_FULL if there is
+ *              no room for a new node, otherwise INVALID.
+ */
+u32
+log(u32 ID, u32 TIME)
+{
+  if (TIME < 0)
+    {
+      logNormal("log:  No time-traveling or overflow allowed!\n");
+      API_ASSERT_GREATER_EQUAL(TIME, 0); // blinkcode!
+    }
+
+  u32 i = nodeFind(ID); // Look for an existing match in the list of previous PING'ers
+
+  if (INVALID != i)
+    {
+      if (!seenCheck(i, TIME))
+        { // If there is a match and it is a new packet
+          if (PC_NODE_ARR[i] < 0xffff) // Make sure ping count won't overflow
+            ++PC_NODE_ARR[i]; // So we can keep track of the valid packet
+          else
+            // Notify us if the ping count will overflow
+            logNormal("Limit of pings reached for IXM %t\n", ID);
+
+          seenRecord(i, TIME); // Update nodular time-stamps
+          TS_HOST_ARR[i] = millis(); // Update host-based time-stamp
+
+          return i; // Return the location of the existing node
+        }
+
+      else
+        { // Don't forward the packet if it was seen before or is stale
+          ++STAT_ARR[STAT_DUPLICATE];
+          trace(TRACE_DUP, ID, TIME);
+          return INVALID;
+        }
+    }
+
+  // Otherwise check to see if there is any free space left in the array
+  if ((NODE_COUNT >= NODE_CAPACITY) && (INVALID == nodeEvict()))
+    { // and whether an idle node can make way
+      logNormal("Inadequate memory space in ID table.\n");
+      return TABLE_FULL; // see overflowSeen
+    }
+
+  // Add the new IXM board to the phone-book.
+  ID_NODE_ARR[NODE_COUNT] = ID;
+  TS_NODE_ARR[NODE_COUNT] = TIME;
+
+  for (u32 w = 0; w < SEEN_WINDOW; ++w)
+    SEEN_NODE_ARR[NODE_COUNT][w] = TIME; // start the seen-window off
+
+  TS_HOST_ARR[NODE_COUNT] = millis();
+  ++PC_NODE_ARR[NODE_COUNT];
+  nodeIndex(NODE_COUNT);
+  JOIN_TS = millis(); // the grid is still being discovered (see ballotsOut)
+
+  if (NODE_COUNT >= CONV_NODES_ARR[CONV_HEAD]) // for the (v)ersion report
+    CONV_NODES_ARR[CONV_HEAD] = NODE_COUNT + 1;
+
+  return NODE_COUNT++; // And pass it on
+}
+
+/*
+ * Summary:     Counts the ballots that may still come in for a calculation
+ *              version:  one from each board that hasn't voted, out of those in
+ *              the node table or EXPECTED_BOARDS, whichever is more.  Without
+ *              EXPECTED_BOARDS, boards that haven't been heard from yet could
+ *              vote as well, so nothing is ruled out until no new board has
+ *              turned up for DISCOVERY_BEATS stable heartbeat intervals, by
+ *              when every board that's on would have been heard.
+ * Parameters:  u32 ballots counted so far.
+ * Return:      Count of the ballots still out, INVALID while the grid is still
+ *              being discovered.
+ */
+u32
+ballotsOut(u32 votes)
+{
+  if ((0 == EXPECTED_BOARDS) && ((millis() - JOIN_TS) < (DISCOVERY_BEATS
+      * BEAT_STABLE)))
+    return INVALID; // more boards may be on their way
+
+  u32 boards = (NODE_COUNT > EXPECTED_BOARDS) ? NODE_COUNT : EXPECTED_BOARDS;
+
+  return (boards > votes) ? (boards - votes) : 0;
+}
+
+/*
+ * Summary:     Declares the majority final once the leading candidate is ahead
+ *              by more votes than there are ballots still out (see
+ *              ballotsOut), after which the tally is done with.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+finalCheck()
+{
+  if (MAJORITY_FINAL || (0 == MAJORITY_RSLT) || (TIE == MAJORITY_RSLT))
+    return;
+
+  u32 out = ballotsOut(VOTE_COUNT);
+
+  if ((INVALID != out) && ((TALLY_TOP - TALLY_NEXT) > out))
+    { // not even the ballots still out could change it
+      MAJORITY_FINAL = true;
+      CONV_FINAL_ARR[CONV_HEAD] = millis() - VER_TS; // (v)ersion report
+      trace(TRACE_FINAL, ID_HOST, MAJORITY_RSLT);
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Evaluates the votes for all of the candidates and changes the
+ *              RESULT (global variable for majority) appropriately, and
+ *              whether it's final (see finalCheck).
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+evalMajority()
+{
+  if (MAJORITY_FINAL) // nothing left to evaluate
+    return;
+
+  if (VOTE_COUNT >= VOTE_COUNT_MIN) // If there are at least 2 active nodes
+    {
+      if (0 == (HOST_CALC & WORK_ARG_MASK)) // Consider 0 an invalid calculation
+        {
+          flush(); // and reset everything
+          return;
+        }
+
+      // The leading candidate, unless another one has as many votes
+      u32 j = (TALLY_NEXT == TALLY_TOP) ? TIE : TALLY_LEAD;
+
+      if (TIE == j) // turn off the LED's in a tie-case
+        {
+          if (TIE != MAJORITY_RSLT)
+            {
+              CONV_RSLT_ARR[CONV_HEAD] = TIE; // (v)ersion report
+              trace(TRACE_MAJORITY, ID_HOST, TIE);
+            }
+
+          MAJORITY_RSLT = TIE; // set the tie as an indicator
+          setStatus(OFF);
+          return;
+        }
+
+      else // if there was no tie
+        {
+          if (MAJORITY_RSLT != CANDIDATE_ARR[j])
+            { // the majority changed
+              CONV_MS_ARR[CONV_HEAD] = millis() - VER_TS; // (v)ersion report
+              CONV_RSLT_ARR[CONV_HEAD] = CANDIDATE_ARR[j];
+              trace(TRACE_MAJORITY, ID_HOST, CANDIDATE_ARR[j]);
+            }
+
+          MAJORITY_RSLT = CANDIDATE_ARR[j]; // set majority accordingly
+          setStatus((VOTE_NODE_ARR[0] == CANDIDATE_ARR[j]) ? MAJORITY
+              : MINORITY); // set host LED based off of agreement.
+          finalCheck();
+
+          return;
+        }
+    }
+
+  else
+    setStatus(OFF); // Inadequate amount of IXM's for voting
+
+  return;
+}
+
+/*
+ * Summary:     Fixed-point base-2 logarithm, computed one fractional bit at a
+ *              time by repeated squaring of the normalized mantissa.
+ * Parameters:  u32 value to take the logarithm of (must be non-zero).
+ * Return:      log2(x) in 16.16 fixed-point, rounded down.
+ */
+u32
+log2Fixed(u32 x)
+{
+  if (0 == x) // log of zero is undefined
+    {
+      logNormal("log2Fixed:  Invalid input %d\n", x);
+      API_ASSERT_GREATER(x, 0); // blinkcode!
+    }
+
+  u32 ip = 0; // integer part
+  while ((ip < 31) && (x >> (ip + 1)))
+    ++ip;
+
+  u64 y = ((u64) x << 31) >> ip; // mantissa in [1, 2) as Q1.31
+  u32 fp = 0; // fractional part
+
+  for (u32 i = 0; i < 16; ++i)
+    {
+      y = (y * y) >> 31; // square the mantissa
+      fp <<= 1;
+
+      if (y >= ((u64) 1 << 32)) // mantissa went past 2.0
+        {
+          y >>= 1; // renormalize
+          fp |= 1; // and record the bit
+        }
+    }
+
+  return (ip << 16) | fp;
+}
+
+/*
+ * Summary:     Fixed-point natural logarithm, rounded up so that bounds built
+ *              on top of it stay on the safe side.
+ * Parameters:  u32 value to take the logarithm of (must be non-zero).
+ * Return:      ln(x) in 16.16 fixed-point.
+ */
+u32
+lnFixed(u32 x)
+{
+  // ln(x) = log2(x) * ln(2); 45426 / 65536 is ln(2) to 16 bits
+  return (u32) (((u64) log2Fixed(x) * 45426) >> 16) + 1;
+}
+
+/*
+ * Summary:     Upper bound for the n_th prime (Rosser's theorem):
+ *              p_n < n(ln n + ln ln n) for n >= 6.
+ * Parameters:  n - the prime sequence.
+ * Return:      An integer strictly greater than the n_th prime.
+ */
+u32
+primeBound(u32 n)
+{
+  if (n < 6) // the theorem only holds from the 6th prime onwards
+    return 12; // and the 5th prime is 11
+
+  u32 lnn = lnFixed(n);
+  u32 lnlnn = lnFixed((lnn >> 16) + 1); // (ln n) rounded up
+
+  u64 bound = (((u64) n * (lnn + lnlnn)) >> 16) + 1;
+
+  return (bound > 0xffffffff) ? 0xffffffff : (u32) bound;
+}
+
+/*
+ * Summary:     Counts the set bits of a word (SWAR population count).
+ * Parameters:  u32 word.
+ * Return:      Number of bits set.
+ */
+u32
+bitCount(u32 v)
+{
+  v = v - ((v >> 1) & 0x55555555);
+  v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+
+  return (((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
+
+/*
+ * Summary:     Locates the k_th set bit of a word.
+ * Parameters:  u32 word, u32 k (1 for the lowest set bit).
+ * Return:      Position of the bit, or INVALID if the word has fewer bits set.
+ */
+u32
+bitSelect(u32 v, u32 k)
+{
+  for (u32 b = 0; b < 32; ++b)
+    if (((v >> b) & 1) && (0 == --k))
+      return b;
+
+  return INVALID;
+}
+
+/*
+ * Summary:     Integer square root.
+ * Parameters:  u32 value.
+ * Return:      The largest integer whose square doesn't exceed the value.
+ */
+u32
+isqrt(u32 x)
+{
+  u32 r = 0;
+
+  for (u32 bit = (u32) 1 << 15; bit; bit >>= 1) // one bit of the root at a time
+    if ((r | bit) * (r | bit) <= x)
+      r |= bit;
+
+  return r;
+}
+
+/*
+ * Summary:     Integer cube root.
+ * Parameters:  u32 value.
+ * Return:      The largest integer whose cube doesn't exceed the value.
+ */
+u32
+icbrt(u32 x)
+{
+  u32 r = 0;
+
+  for (u32 bit = (u32) 1 << 10; bit; bit >>= 1) // one bit of the root at a time
+    if (((u64) (r | bit) * (r | bit) * (r | bit)) <= x)
+      r |= bit;
+
+  return r;
+}
+
+/*
+ * Summary:     Checks whether an odd integer is crossed off in the sieve.
+ * Parameters:  u32 odd integer below SIEVE_LIMIT.
+ * Return:      True if the integer is composite (or 1).
+ */
+bool
+sieveTest(u32 x)
+{
+  return (sieve[x >> 6] >> ((x >> 1) & 31)) & 1;
+}
+
+/*
+ * Summary:     Crosses an odd integer off in the sieve.
+ * Parameters:  u32 odd integer below the sieve capacity.
+ * Return:      None.
+ */
+void
+sieveMark(u32 x)
+{
+  sieve[x >> 6] |= ((u32) 1 << ((x >> 1) & 31));
+
+  return;
+}
+
+/*
+ * Summary:     Extends the retained sieve so that every integer below the
+ *              limit is marked.  Work already done for a lower limit is kept,
+ *              only the new range [SIEVE_LIMIT, limit) is crossed off.  Only
+ *              odd integers are stored, one bit each, and the limit is
+ *              rounded up to a whole sieve word (64 integers).
+ * Parameters:  u32 limit to sieve up to (not inclusive).
+ * Return:      None.
+ */
+void
+sieveExtend(u32 limit)
+{
+  if (limit > (SIEVE_WORDS * 64)) // never reach past the sieve array
+    limit = SIEVE_WORDS * 64;
+
+  limit = ((limit + 63) / 64) * 64; // whole words only
+
+  if (limit <= SIEVE_LIMIT) // already sieved
+    return;
+
+  u32 low = SIEVE_LIMIT; // beginning of the new range
+
+  for (u32 w = low / 64; w < limit / 64; ++w)
+    sieve[w] = 0; // assume the new range is prime
+
+  if (0 == low)
+    sieveMark(1); // 1 isn't prime
+
+  // Primes are visited in ascending order, so by the time p is reached every
+  // smaller prime has already crossed off its multiples in the new range.
+  for (u32 p = 3; p * p < limit; p += 2)
+    {
+      if (sieveTest(p))
+        continue;
+
+      u32 k = p * p; // smaller multiples were crossed off by smaller primes
+
+      if (k < low)
+        { // start from the first odd multiple within the new range
+          u32 m = (low + p - 1) / p;
+          k = ((m & 1) ? m : m + 1) * p;
+        }
+
+      for (; k < limit; k += p + p) // even multiples aren't stored
+        sieveMark(k);
+    }
+
+  SIEVE_LIMIT = limit;
+
+  return;
+}
+
+/*
+ * Summary:     Locates the n_th prime in the retained sieve, a word at a time.
+ *              The search resumes from the word holding the last prime located
+ *              so repeated or ascending requests skip the words before it.
+ * Parameters:  n - the prime sequence to locate.
+ * Return:      The n_th prime number, or 0 if it's beyond the sieve.
+ */
+u32
+nthPrime(u32 n)
+{
+  if (n < 1) // there is no 0_th prime
+    return 0;
+
+  if (1 == n) // 2 is the only prime the sieve doesn't store
+    return 2;
+
+  sieveExtend(primeBound(n)); // only sieves what hasn't been sieved yet
+
+  u32 target = n - 1; // odd primes to count, 3 being the first
+  u32 w = 0;
+  u32 c = 0;
+
+  if (target > PRIME_CURSOR_N) // resume from the last word visited
+    {
+      w = PRIME_CURSOR_W;
+      c = PRIME_CURSOR_N;
+    }
+
+  for (; w < (SIEVE_LIMIT / 64); ++w)
+    {
+      u32 primes = ~sieve[w]; // clear bits are primes
+      u32 found = bitCount(primes);
+
+      if (c + found >= target)
+        { // the prime is within this word
+          PRIME_CURSOR_W = w;
+          PRIME_CURSOR_N = c;
+
+          return (((w << 5) + bitSelect(primes, target - c)) << 1) + 1;
+        }
+
+      c += found;
+    }
+
+  return 0;
+}
+
+/*
+ * Summary:     Sieves one segment [low, low + SEGMENT_WORDS * 64) into the
+ *              segment buffer using the base primes held in the sieve, which
+ *              must already reach past the square root of the segment's end.
+ * Parameters:  u32 start of the segment (a multiple of 64).
+ * Return:      Count of odd primes within the segment.
+ */
+u32
+segmentSieve(u32 low)
+{
+  u64 high = (u64) low + (SEGMENT_WORDS * 64); // end of the segment
+
+  for (u32 w = 0; w < SEGMENT_WORDS; ++w)
+    segment[w] = 0; // assume the segment is prime
+
+  if (0 == low)
+    segment[0] |= 1; // 1 isn't prime
+
+  for (u32 p = 3; ((u64) p * p) < high; p += 2)
+    {
+      if (sieveTest(p))
+        continue;
+
+      u64 k = (u64) p * p;
+
+      if (k < low)
+        { // start from the first odd multiple within the segment
+          u32 m = low / p + ((low % p) ? 1 : 0);
+          k = (u64) ((m & 1) ? m : m + 1) * p;
+        }
+
+      for (; k < high; k += p + p) // even multiples aren't stored
+        segment[(k - low) >> 6] |= ((u32) 1 << (((k - low) >> 1) & 31));
+    }
+
+  u32 found = 0;
+
+  for (u32 w = 0; w < SEGMENT_WORDS; ++w)
+    found += bitCount(~segment[w]);
+
+  return found;
+}
+
+/*
+ * Summary:     Counts the primes among the first odd integers of the segment
+ *              buffer.
+ * Parameters:  u32 count of odd integers to look at.
+ * Return:      Count of odd primes among them.
+ */
+u32
+segmentCount(u32 odds)
+{
+  u32 found = 0;
+
+  for (u32 w = 0; w < (odds >> 5); ++w)
+    found += bitCount(~segment[w]);
+
+  if (odds & 31)
+    found += bitCount(~segment[odds >> 5] & (((u32) 1 << (odds & 31)) - 1));
+
+  return found;
+}
+
+/*
+ * Summary:     Remembers the count of odd primes below a segment if it starts
+ *              on the next unknown prime count checkpoint.
+ * Parameters:  u32 start of the segment, u32 count of odd primes below it.
+ * Return:      None.
+ */
+void
+piRecord(u32 low, u32 count)
+{
+  if ((low == (PI_INDEX_TOP * PI_STRIDE)) && (PI_INDEX_TOP < PI_INDEX_SIZE))
+    PI_INDEX_ARR[PI_INDEX_TOP++] = count;
+
+  return;
+}
+
+/*
+ * Summary:     Finds the highest known prime count checkpoint at or below x
+ *              that has fewer than count odd primes below it.
+ * Parameters:  u32 x, u32 count (INVALID for any).
+ * Return:      Index of the checkpoint; 0 (below which there are none) at
+ *              worst.
+ */
+u32
+piCheckpoint(u32 x, u32 count)
+{
+  u32 k = x / PI_STRIDE;
+
+  if (k >= PI_INDEX_TOP)
+    k = PI_INDEX_TOP - 1;
+
+  while ((k > 0) && (PI_INDEX_ARR[k] >= count))
+    --k;
+
+  return k;
+}
+
+/*
+ * Summary:     One step towards the n_th prime in the retained sieve; the sieve
+ *              is extended by at most one segment's worth of integers per step.
+ * Parameters:  n - the prime sequence to locate, u32 pointer for the result.
+ * Return:      True once the result (0 if it's beyond the sieve) is stored.
+ */
+bool
+sieveStep(u32 n, u32 * rslt)
+{
+  u32 limit = primeBound(n);
+
+  if (limit > (SIEVE_WORDS * 64)) // never reach past the sieve array
+    limit = SIEVE_WORDS * 64;
+
+  if (SIEVE_LIMIT < limit)
+    { // sieve another block before looking
+      sieveExtend(((limit - SIEVE_LIMIT) > (SEGMENT_WORDS * 64)) ? (SIEVE_LIMIT
+          + (SEGMENT_WORDS * 64)) : limit);
+      return false;
+    }
+
+  *rslt = nthPrime(n);
+
+  return true;
+}
+
+/*
+ * Summary:     One step towards the n_th prime by streaming fixed-size
+ *              segments, so the memory cost is the base primes up to the
+ *              square root of the answer plus one segment buffer, however
+ *              large n is.  Each step sieves a single segment.  The last
+ *              segment visited is remembered so ascending requests resume
+ *              from it, and anything else from the closest prime count
+ *              checkpoint, instead of from 0.
+ * Parameters:  n - the prime sequence to locate, u32 pointer for the result.
+ * Return:      True once the result (0 if it can't be reached) is stored.
+ */
+bool
+segmentStep(u32 n, u32 * rslt)
+{
+  *rslt = 0;
+
+  if (n < 1) // there is no 0_th prime
+    return true;
+
+  if (1 == n) // 2 is the only prime the segments don't store
+    {
+      *rslt = 2;
+      return true;
+    }
+
+  u32 limit = primeBound(n);
+  u32 target = n - 1; // odd primes to count, 3 being the first
+
+  if ((isqrt(limit) + 1) >= (SIEVE_WORDS * 64)) // base primes won't fit
+    return true;
+
+  sieveExtend(isqrt(limit) + 1); // base primes
+
+  u32 k = piCheckpoint(limit, target);
+
+  if ((target <= SEGMENT_COUNT) || ((k * PI_STRIDE) > SEGMENT_LOW))
+    { // resume from the closest checkpoint below the answer instead
+      SEGMENT_LOW = k * PI_STRIDE;
+      SEGMENT_COUNT = PI_INDEX_ARR[k];
+    }
+
+  piRecord(SEGMENT_LOW, SEGMENT_COUNT);
+  u32 found = segmentSieve(SEGMENT_LOW);
+
+  if (SEGMENT_COUNT + found < target)
+    { // the prime is further along
+      SEGMENT_COUNT += found;
+
+      if (((u64) SEGMENT_LOW + (SEGMENT_WORDS * 64)) >= limit)
+        return true; // this should never happen
+
+      SEGMENT_LOW += SEGMENT_WORDS * 64;
+      return false;
+    }
+
+  u32 c = SEGMENT_COUNT;
+
+  for (u32 w = 0; w < SEGMENT_WORDS; ++w)
+    {
+      u32 primes = ~segment[w];
+      found = bitCount(primes);
+
+      if (c + found >= target)
+        { // the prime is within this word, unless it's past 2^32
+          u64 p = (u64) SEGMENT_LOW + ((((w << 5) + bitSelect(primes, target
+              - c)) << 1) + 1);
+          *rslt = (p > 0xffffffff) ? 0 : (u32) p;
+          break;
+        }
+
+      c += found;
+    }
+
+  return true;
+}
+
+/*
+ * Summary:     Builds the tables phi() works from, once:  the first primes and
+ *              phi(m, PHI_SMALL) for every m below PHI_PRIMORIAL.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+phiInit()
+{
+  if (0 != PHI_PRIME_ARR[1]) // already built
+    return;
+
+  sieveExtend(2048); // the listed primes stop at 1627
+
+  PHI_PRIME_ARR[1] = 2;
+
+  for (u32 p = 3, i = 2; i < PHI_PRIMES; p += 2)
+    if (!sieveTest(p))
+      PHI_PRIME_ARR[i++] = p;
+
+  for (u32 m = 1, c = 0; m < PHI_PRIMORIAL; ++m)
+    {
+      bool coprime = true;
+
+      for (u32 i = 1; i <= PHI_SMALL; ++i)
+        if (0 == (m % PHI_PRIME_ARR[i]))
+          coprime = false;
+
+      PHI_SMALL_ARR[m] = (c += coprime ? 1 : 0);
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Legendre's phi(x, a):  the count of integers in [1, x] that
+ *              none of the first a primes divide.  Uses the recurrence
+ *              phi(x, a) = phi(x, a - 1) - phi(x / p_a, a - 1) unrolled down to
+ *              the tabulated phi(x, PHI_SMALL), so the recursion is only as
+ *              deep as x can be divided by primes past p_PHI_SMALL.
+ * Parameters:  u32 x, u32 a (from PHI_SMALL up, below PHI_PRIMES - 1).
+ * Return:      phi(x, a).
+ */
+u32
+phi(u32 x, u32 a)
+{
+  if (a <= PHI_SMALL)
+    return (x / PHI_PRIMORIAL) * PHI_TOTIENT + PHI_SMALL_ARR[x % PHI_PRIMORIAL];
+
+  if (x < PHI_PRIME_ARR[a + 1]) // nothing but 1 is left
+    return (x > 0) ? 1 : 0;
+
+  u32 sum = phi(x, PHI_SMALL);
+
+  for (u32 i = PHI_SMALL + 1; i <= a; ++i)
+    {
+      u32 y = x / PHI_PRIME_ARR[i];
+
+      if (y < PHI_PRIME_ARR[i])
+        { // phi(y, i - 1) is 1 from here on
+          sum -= a - i + 1;
+          break;
+        }
+
+      sum -= phi(y, i - 1);
+    }
+
+  return sum;
+}
+
+/*
+ * Summary:     One step of counting the primes up to x with Meissel's
+ *              formula, pi(x) = phi(x, a) + a - 1 - P2 with a = pi(x^(1/3))
+ *              and P2 the sum of pi(x / p) - pi(p) + 1 over the primes p in
+ *              (x^(1/3), x^(1/2)].  Each step either sums up one of the top
+ *              terms of phi(x, a) or sieves one segment on the way up to
+ *              x^(2/3) for the pi(x / p) values, so time is roughly x^(2/3)
+ *              and memory is the sieve, one segment and the phi() tables.
+ *              LEHMER_PHASE must be 0 before the first step; JOB_POS and
+ *              JOB_ACC are used as in piStep.
+ * Parameters:  x - the bound to count the primes up to (at least
+ *              PI_STRIDE), u32 pointer for the result.
+ * Return:      True once the result is stored.
+ */
+bool
+lehmerStep(u32 x, u32 * rslt)
+{
+  if (0 == LEHMER_PHASE)
+    { // set up phi(x, a) = phi(x, PHI_SMALL) - the terms for the other primes
+      phiInit();
+      sieveExtend(isqrt(x) + 1); // base primes
+
+      u32 r = icbrt(x);
+
+      for (LEHMER_A = PHI_SMALL; PHI_PRIME_ARR[LEHMER_A + 1] <= r; ++LEHMER_A)
+        ; // a = pi(x^(1/3))
+
+      LEHMER_SUM = phi(x, PHI_SMALL);
+      LEHMER_I = PHI_SMALL + 1;
+      LEHMER_PHASE = LEHMER_PHI;
+      return false;
+    }
+
+  if (LEHMER_PHI == LEHMER_PHASE)
+    {
+      if (LEHMER_I <= LEHMER_A)
+        {
+          LEHMER_SUM -= phi(x / PHI_PRIME_ARR[LEHMER_I], LEHMER_I - 1);
+          ++LEHMER_I;
+          return false;
+        }
+
+      // Start the P2 terms from the largest prime up to x^(1/2), whose
+      // x / p is the smallest
+      LEHMER_SUM += LEHMER_A - 1;
+      LEHMER_P = isqrt(x) | 1;
+
+      while (sieveTest(LEHMER_P))
+        LEHMER_P -= 2;
+
+      LEHMER_I = 1; // 2 isn't in the sieve
+
+      for (u32 w = 0; w < (LEHMER_P >> 6); ++w)
+        LEHMER_I += bitCount(~sieve[w]);
+
+      LEHMER_I += bitCount(~sieve[LEHMER_P >> 6] & ((((u32) 1
+          << ((LEHMER_P >> 1) & 31)) << 1) - 1));
+
+      u32 k = piCheckpoint(x / LEHMER_P, INVALID);
+      JOB_POS = k * PI_STRIDE;
+      JOB_ACC = PI_INDEX_ARR[k] + 1; // 2 is the only prime the segments don't store
+      LEHMER_PHASE = LEHMER_P2;
+      return false;
+    }
+
+  piRecord(JOB_POS, JOB_ACC - 1);
+  u32 found = segmentSieve(JOB_POS);
+  u64 high = (u64) JOB_POS + (SEGMENT_WORDS * 64); // end of the segment
+
+  // x / p only grows as p goes down, so the segments are swept upwards once
+  while ((LEHMER_I > LEHMER_A) && ((x / LEHMER_P) < high))
+    {
+      u32 y = x / LEHMER_P;
+      LEHMER_SUM -= JOB_ACC + segmentCount((y - JOB_POS + 1) >> 1)
+          - (LEHMER_I - 1);
+      --LEHMER_I;
+
+      do
+        LEHMER_P -= 2;
+      while ((LEHMER_P > 2) && sieveTest(LEHMER_P));
+    }
+
+  if (LEHMER_I <= LEHMER_A)
+    {
+      LEHMER_PHASE = LEHMER_DONE;
+      *rslt = LEHMER_SUM;
+      return true;
+    }
+
+  JOB_ACC += found;
+  JOB_POS += SEGMENT_WORDS * 64;
+
+  return false;
+}
+
+/*
+ * Summary:     Tells if the primes up to x are to be counted by lehmerStep:
+ *              once it has started, or if the closest prime count checkpoint
+ *              is more than a stride short of x.
+ * Parameters:  u32 x.
+ * Return:      True for lehmerStep, false for sweeping segments.
+ */
+bool
+piLehmer(u32 x)
+{
+  return (0 != LEHMER_PHASE) || ((x / PI_STRIDE) > PI_INDEX_TOP);
+}
+
+/*
+ * Summary:     Lower bound of the n_th prime, n(ln n + ln ln n - 1 + (ln ln n
+ *              - 2.1) / ln n) (Dusart), rounded down in fixed-point.
+ * Parameters:  n - the prime sequence (at least 4000 for ln ln n > 2.1).
+ * Return:      The bound, rounded down to a segment start (a multiple of 64).
+ */
+u32
+primeLower(u32 n)
+{
+  u32 lnn = lnFixed(n) - 2; // lnFixed rounds up by a unit at most
+  u32 lnlnn = lnFixed(lnn) - 726818 - 2; // ln of 16.16 is 16 ln 2 too high
+
+  u64 bound = ((u64) n * (lnn + lnlnn - 65536 + (((u64) (lnlnn - 137626)
+      << 16) / lnn))) >> 16;
+  bound -= n >> 12; // margin for the fixed-point rounding
+
+  return ((bound > 0xffffffff) ? 0xffffffff : (u32) bound) & ~63;
+}
+
+/*
+ * Summary:     One step towards the n_th prime past the segmented range:
+ *              the primes below a lower bound of the answer are counted with
+ *              lehmerStep, and only the rest of the way is sieved, by
+ *              segmentStep resuming from the bound.
+ * Parameters:  n - the prime sequence to locate, u32 pointer for the result.
+ * Return:      True once the result is stored.
+ */
+bool
+lehmerPrimeStep(u32 n, u32 * rslt)
+{
+  if (LEHMER_DONE != LEHMER_PHASE)
+    {
+      u32 low = primeLower(n);
+      u32 c;
+
+      if (!lehmerStep(low - 1, &c))
+        return false;
+
+      SEGMENT_LOW = low; // segmentStep resumes from here
+      SEGMENT_COUNT = c - 1; // 2 isn't counted there
+      return false;
+    }
+
+  return segmentStep(n, rslt);
+}
+
+/*
+ * Summary:     One step of the n_th prime workload; the retained sieve covers
+ *              the supported range, segments go past it and prime counting
+ *              takes over past them.
+ * Parameters:  n - the prime sequence to locate, u32 pointer for the result.
+ * Return:      True once the result is stored.
+ */
+bool
+primeStep(u32 n, u32 * rslt)
+{
+  if (n <= PRIME_THRESHOLD)
+    return sieveStep(n, rslt);
+
+  if (n <= PRIME_SEGMENTED_THRESHOLD)
+    return segmentStep(n, rslt);
+
+  return lehmerPrimeStep(n, rslt);
+}
+
+/*
+ * Summary:     One step of counting the primes up to x, a segment per step,
+ *              starting from the closest prime count checkpoint (lehmerStep
+ *              takes over far past them).  JOB_POS is the first integer of the
+ *              next segment and JOB_ACC the count of primes below it (0
+ *              before the first step).
+ * Parameters:  x - the bound to count the primes up to, u32 pointer for the
+ *              result.
+ * Return:      True once the result (0 if it can't be reached) is stored.
+ */
+bool
+piStep(u32 x, u32 * rslt)
+{
+  *rslt = 0;
+
+  if ((x < 2) || ((isqrt(x) + 1) >= (SIEVE_WORDS * 64))) // base primes won't fit
+    return true;
+
+  if (piLehmer(x)) // far past the checkpoints
+    return lehmerStep(x, rslt);
+
+  sieveExtend(isqrt(x) + 1); // base primes
+
+  if (0 == JOB_ACC)
+    {
+      u32 k = piCheckpoint(x, INVALID);
+      JOB_POS = k * PI_STRIDE;
+      JOB_ACC = PI_INDEX_ARR[k] + 1; // 2 is the only prime the segments don't store
+    }
+
+  piRecord(JOB_POS, JOB_ACC - 1);
+  u32 found = segmentSieve(JOB_POS);
+
+  if (((u64) JOB_POS + (SEGMENT_WORDS * 64)) <= x)
+    { // the whole segment is below x
+      JOB_ACC += found;
+      JOB_POS += SEGMENT_WORDS * 64;
+      return false;
+    }
+
+  // odd integers of the segment up to x
+  *rslt = JOB_ACC + segmentCount((x - JOB_POS + 1) >> 1);
+
+  return true;
+}
+
+/*
+ * Summary:     One step of verifying that p is the n_th prime instead of
+ *              locating it:  p is first tested by trial division,
+ *              VERIFY_DIVISORS odd divisors per step, then the primes below
+ *              it are counted a segment per step from the closest prime
+ *              count checkpoint, or with lehmerStep far past them.  JOB_POS
+ *              holds the next divisor while dividing and is then used with
+ *              JOB_ACC as in piStep.
+ * Parameters:  n - the prime sequence, p - the candidate, bool pointer for
+ *              the verdict.
+ * Return:      True once the verdict is stored.
+ */
+bool
+verifyStep(u32 n, u32 p, bool * ok)
+{
+  *ok = false;
+
+  if ((0 == JOB_ACC) && (0 == LEHMER_PHASE))
+    { // test the candidate before counting anything
+      if (0 == JOB_POS)
+        {
+          if ((n < 2) || (p < 3) || (0 == (p & 1)) || (p > primeBound(n)))
+            {
+              *ok = ((1 == n) && (2 == p)); // 2 is the only even prime
+              return true;
+            }
+
+          if ((isqrt(p) + 1) >= (SIEVE_WORDS * 64)) // base primes won't fit
+            return true;
+
+          sieveExtend(isqrt(p) + 1); // base primes
+          JOB_POS = 3;
+        }
+
+      u32 r = isqrt(p);
+      u32 last = JOB_POS + 2 * (VERIFY_DIVISORS - 1);
+      u32 d;
+
+      for (d = JOB_POS; (d <= r) && (d <= last); d += 2)
+        if (!sieveTest(d) && (0 == (p % d)))
+          return true; // not even a prime
+
+      if (d <= r)
+        { // more divisors to try in the next step
+          JOB_POS = d;
+          return false;
+        }
+
+      JOB_POS = 0;
+
+      if (!piLehmer(p - 1)) // otherwise lehmerStep counts them
+        {
+          u32 k = piCheckpoint(p, INVALID);
+          JOB_POS = k * PI_STRIDE;
+          JOB_ACC = PI_INDEX_ARR[k] + 1; // 2 is the only prime the segments don't store
+        }
+    }
+
+  if (piLehmer(p - 1))
+    {
+      u32 c;
+
+      if (!lehmerStep(p - 1, &c))
+        return false;
+
+      *ok = (c == (n - 1));
+      return true;
+    }
+
+  piRecord(JOB_POS, JOB_ACC - 1);
+  u32 found = segmentSieve(JOB_POS);
+
+  if (((u64) JOB_POS + (SEGMENT_WORDS * 64)) <= p)
+    { // the whole segment is below p
+      JOB_ACC += found;
+      JOB_POS += SEGMENT_WORDS * 64;
+      return (JOB_ACC >= n); // too many primes below p already
+    }
+
+  // odd integers of the segment below p
+  *ok = ((JOB_ACC + segmentCount((p - JOB_POS) >> 1)) == (n - 1));
+
+  return true;
+}
+
+/*
+ * Summary:     Byte i of the buffer the CRC workload runs over; a cheap
+ *              integer hash of i so it never has to be stored.
+ * Parameters:  u32 seed of the buffer, u32 i.
+ * Return:      The byte.
+ */
+u8
+crcByte(u32 seed, u32 i)
+{
+  u32 v = (i ^ seed) * 2654435761u;
+
+  return (u8) ((v ^ (v >> 15)) >> 8);
+}
+
+/*
+ * Summary:     One step of the CRC-32 (IEEE, reflected) of n generated bytes,
+ *              WORK_CHUNK bytes per step, a nibble at a time so the table
+ *              stays small.  JOB_POS is the bytes done, JOB_ACC the running
+ *              CRC register.
+ * Parameters:  n - the count of bytes, u32 pointer for the result.
+ * Return:      True once the result is stored.
+ */
+bool
+crcStep(u32 n, u32 * rslt)
+{
+  static const u32 CRC_NIBBLE_ARR[16] =
+    { 0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4,
+        0x4db26158, 0x5005713c, 0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+        0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c };
+
+  if (0 == JOB_POS)
+    JOB_ACC = 0xffffffff;
+
+  u32 end = ((n - JOB_POS) > WORK_CHUNK) ? (JOB_POS + WORK_CHUNK) : n;
+  u32 crc = JOB_ACC;
+
+  for (u32 i = JOB_POS; i < end; ++i)
+    {
+      crc ^= crcByte(n, i);
+      crc = (crc >> 4) ^ CRC_NIBBLE_ARR[crc & 15];
+      crc = (crc >> 4) ^ CRC_NIBBLE_ARR[crc & 15];
+    }
+
+  JOB_ACC = crc;
+  JOB_POS = end;
+
+  if (end < n)
+    return false;
+
+  *rslt = ~crc;
+
+  return true;
+}
+
+/*
+ * Summary:     One step of a chain of n FNV-1a rounds, each hashing the four
+ *              bytes of the last one, WORK_CHUNK rounds per step.  JOB_POS is
+ *              the rounds done, JOB_ACC the last hash.
+ * Parameters:  n - the count of rounds, u32 pointer for the result.
+ * Return:      True once the result is stored.
+ */
+bool
+hashStep(u32 n, u32 * rslt)
+{
+  if (0 == JOB_POS)
+    JOB_ACC = n; // the chain is seeded with its length
+
+  u32 end = ((n - JOB_POS) > WORK_CHUNK) ? (JOB_POS + WORK_CHUNK) : n;
+  u32 h = JOB_ACC;
+
+  for (u32 i = JOB_POS; i < end; ++i)
+    {
+      u32 v = h;
+      h = 2166136261u;
+
+      for (u32 b = 0; b < 4; ++b, v >>= 8)
+        h = (h ^ (v & 0xff)) * 16777619u;
+    }
+
+  JOB_ACC = h;
+  JOB_POS = end;
+
+  if (end < n)
+    return false;
+
+  *rslt = h;
+
+  return true;
+}
+
+/*
+ * Summary:     Width of the parts a (p)artitioned calculation up to n is split
+ *              into:  PART_COUNT of them at most, whole segments each.
+ * Parameters:  u32 n.
+ * Return:      Integers per part.
+ */
+u32
+partSpan(u32 n)
+{
+  u32 span = n / PART_COUNT + 1;
+
+  return ((span + (SEGMENT_WORDS * 64) - 1) / (SEGMENT_WORDS * 64))
+      * (SEGMENT_WORDS * 64);
+}
+
+/*
+ * Summary:     Starts the (p)art votes over if they're for an older version.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+partReset()
+{
+  if (PART_VER == HOST_CALC_VER)
+    return;
+
+  for (u32 j = 0; j < PART_COUNT; ++j)
+    {
+      PART_MAJORITY_ARR[j] = 0;
+
+      for (u32 k = 0; k < PART_SLOTS; ++k)
+        {
+          PART_ID_ARR[j][k] = 0;
+          PART_RSLT_ARR[j][k] = 0;
+        }
+    }
+
+  PART_VER = HOST_CALC_VER;
+  PART_TS = millis();
+
+  return;
+}
+
+/*
+ * Summary:     Looks up the vote of a board for a part.
+ * Parameters:  u32 part, u32 board ID.
+ * Return:      Slot of the vote, INVALID if the board hasn't voted for it.
+ */
+u32
+partSlot(u32 j, u32 ID)
+{
+  for (u32 k = 0; k < PART_SLOTS; ++k)
+    if ((0 != PART_RSLT_ARR[j][k]) && (ID == PART_ID_ARR[j][k]))
+      return k;
+
+  return INVALID;
+}
+
+/*
+ * Summary:     Takes in a vote for a part; the part is settled once
+ *              PART_QUORUM of its votes agree.
+ * Parameters:  u32 voter ID, u32 part, u32 count of primes within it.
+ * Return:      True if the vote is new, false if it's a repeat or there is no
+ *              room left for it (so it isn't forwarded any further).
+ */
+bool
+partVote(u32 ID, u32 j, u32 count)
+{
+  if (INVALID != partSlot(j, ID))
+    return false; // heard it already
+
+  u32 k = 0;
+
+  while ((k < PART_SLOTS) && (0 != PART_RSLT_ARR[j][k]))
+    ++k;
+
+  if (k >= PART_SLOTS)
+    return false;
+
+  PART_ID_ARR[j][k] = ID;
+  PART_RSLT_ARR[j][k] = count + 1;
+  PART_TS = millis();
+  ++STAT_ARR[STAT_PART_VOTES];
+
+  u32 same = 0;
+
+  for (k = 0; k < PART_SLOTS; ++k)
+    if ((count + 1) == PART_RSLT_ARR[j][k])
+      ++same;
+
+  if ((0 == PART_MAJORITY_ARR[j]) && (same >= PART_QUORUM))
+    PART_MAJORITY_ARR[j] = count + 1;
+
+  return true;
+}
+
+/*
+ * Summary:     Sends a (p)art vote out of every face but the one it came from,
+ *              after any records still queued there so the neighbors hear of
+ *              the calculation version before its votes.
+ * Parameters:  u32 voter ID, u32 part, u32 count of primes within it, u32
+ *              source face (INVALID for the host's own votes).
+ * Return:      None.
+ */
+void
+partSend(u32 ID, u32 j, u32 count, u32 face)
+{
+  for (u32 i = 0; i < FACE_COUNT; ++i)
+    if ((TERMINAL_FACE != i) && (face != i) && treeFace(i))
+      {
+        batchSend(i); // the records announcing the version go out first
+        facePrintf(i, "p%t,%d,%d,%d\n", ID, PART_VER, j, count);
+      }
+
+  return;
+}
+
+/*
+ * Summary:     Notes the host's rank among the IDs of the active boards and
+ *              how many there are, which deals the parts out.  Boards that
+ *              see the same grid deal them out the same way.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+partRank()
+{
+  PART_RANK = 0;
+  PART_BOARDS = 1;
+
+  for (u32 i = 1; i < NODE_COUNT; ++i)
+    if ((millis() - TS_HOST_ARR[i]) < IDLE_TIMEOUT)
+      {
+        ++PART_BOARDS;
+
+        if (ID_NODE_ARR[i] < ID_HOST)
+          ++PART_RANK;
+      }
+
+  return;
+}
+
+/*
+ * Summary:     Tells if a part was dealt to the host:  replica t of part j
+ *              goes to rank (j * PART_REPLICAS + t) modulo the boards.
+ * Parameters:  u32 part.
+ * Return:      True if the host is one of its PART_REPLICAS boards.
+ */
+bool
+partMine(u32 j)
+{
+  for (u32 t = 0; t < PART_REPLICAS; ++t)
+    if (((j * PART_REPLICAS + t) % PART_BOARDS) == PART_RANK)
+      return true;
+
+  return (PART_BOARDS <= PART_REPLICAS);
+}
+
+/*
+ * Summary:     One step of a (p)artitioned count of the primes up to n:  the
+ *              host sieves the parts dealt to it, a segment per step, and
+ *              votes on each part's count with a (p)art packet.  The answer
+ *              is the sum of the parts' majorities.  Parts nobody settles
+ *              for PART_TIMEOUT are counted by whoever is left waiting (or
+ *              get the host's vote sent again if it counted them already),
+ *              and a part is dropped if the others settle it first.  A FAULTY
+ *              board's part counts are one too high.  JOB_PART is the part
+ *              being counted, JOB_POS and JOB_ACC are used as in piStep.
+ * Parameters:  n - the bound to count the primes up to, u32 pointer for the
+ *              result.
+ * Return:      True once the result is stored; JOB_IDLE is set if there's
+ *              nothing to do but wait for votes.
+ */
+bool
+partStep(u32 n, u32 * rslt)
+{
+  u32 span = partSpan(n);
+  u32 parts = n / span + 1;
+
+  JOB_IDLE = false;
+
+  if ((INVALID != JOB_PART) && (0 != PART_MAJORITY_ARR[JOB_PART]))
+    JOB_PART = INVALID; // the others settled it meanwhile
+
+  if (INVALID == JOB_PART)
+    { // pick the next part to count, if any
+      u32 sum = 0;
+      bool settled = true;
+
+      for (u32 i = 0; i < parts; ++i)
+        {
+          u32 j = (PART_RANK + i) % parts; // boards left waiting spread out
+
+          if (0 != PART_MAJORITY_ARR[j])
+            {
+              sum += PART_MAJORITY_ARR[j] - 1;
+              continue;
+            }
+
+          settled = false;
+
+          if ((INVALID == JOB_PART) && (INVALID == partSlot(j, ID_HOST))
+              && (partMine(j) || ((millis() - PART_TS) >= PART_TIMEOUT)))
+            JOB_PART = j;
+        }
+
+      if (settled)
+        {
+          *rslt = sum;
+          return true;
+        }
+
+      if (INVALID == JOB_PART)
+        {
+          if ((millis() - PART_TS) >= PART_TIMEOUT)
+            { // a vote may have been lost, or dropped before its version
+              for (u32 j = 0; j < parts; ++j)
+                {
+                  u32 k = partSlot(j, ID_HOST);
+
+                  if ((0 == PART_MAJORITY_ARR[j]) && (INVALID != k))
+                    partSend(ID_HOST, j, PART_RSLT_ARR[j][k] - 1, INVALID);
+                }
+
+              PART_TS = millis();
+            }
+
+          JOB_IDLE = true;
+          return false;
+        }
+
+      sieveExtend(isqrt(n) + 1); // base primes
+      JOB_POS = JOB_PART * span;
+      JOB_ACC = (0 == JOB_PART) ? 1 : 0; // 2 is the only prime the segments don't store
+    }
+
+  u64 end = (u64) (JOB_PART + 1) * span; // end of the part
+
+  if (end > ((u64) n + 1))
+    end = (u64) n + 1;
+
+  u32 found = segmentSieve(JOB_POS);
+  ++STAT_ARR[STAT_PART_SEGMENTS];
+
+  if (((u64) JOB_POS + (SEGMENT_WORDS * 64)) < end)
+    { // the part goes on past this segment
+      JOB_ACC += found;
+      JOB_POS += SEGMENT_WORDS * 64;
+      return false;
+    }
+
+  // odd integers of the segment below the end
+  u32 count = JOB_ACC + segmentCount((u32) (end - JOB_POS) >> 1)
+      + (JOB_FAULTY ? 1 : 0);
+
+  partVote(ID_HOST, JOB_PART, count);
+  partSend(ID_HOST, JOB_PART, count, INVALID);
+  JOB_PART = INVALID;
+
+  return false;
+}
+
+/*
+ * Summary:     Workload registry:  the step of each workload, indexed like
+ *              the WORK_*_ARR arrays.  A step is called until it returns true
+ *              and must keep any progress in JOB_POS/JOB_ACC, which start at 0
+ *              for every job.
+ */
+typedef bool
+(*WORK_STEP)(u32 arg, u32 * rslt);
+const WORK_STEP WORK_STEP_ARR[WORK_COUNT] =
+  { primeStep, piStep, crcStep, hashStep, partStep };
+
+/*
+ * Summary:     Looks up a previous result in the result cache.
+ * Parameters:  u32 calculation, bool FAULTY flag it's calculated with.
+ * Return:      Index of the cached result, INVALID if it isn't cached.
+ */
+u32
+cacheFind(u32 calc, bool faulty)
+{
+  for (u32 i = 0; i < CACHE_SIZE; ++i)
+    if ((0 != CACHE_RSLT_ARR[i]) && (calc == CACHE_CALC_ARR[i])
+        && (faulty == CACHE_FAULTY_ARR[i]))
+      return i;
+
+  return INVALID;
+}
+
+/*
+ * Summary:     Remembers a result in the result cache, replacing a free entry
+ *              or else the least recently used one.
+ * Parameters:  u32 calculation, bool FAULTY flag it's calculated with, u32
+ *              result.
+ * Return:      None.
+ */
+void
+cacheStore(u32 calc, bool faulty, u32 rslt)
+{
+  if (0 == rslt) // 0 is never a correct answer, so it marks free entries
+    return;
+
+  u32 k = 0;
+
+  for (u32 i = 0; i < CACHE_SIZE; ++i)
+    {
+      if (0 == CACHE_RSLT_ARR[i])
+        { // free entries are taken first
+          k = i;
+          break;
+        }
+
+      if (CACHE_USED_ARR[i] < CACHE_USED_ARR[k])
+        k = i; // otherwise, the least recently used entry
+    }
+
+  CACHE_CALC_ARR[k] = calc;
+  CACHE_FAULTY_ARR[k] = faulty;
+  CACHE_RSLT_ARR[k] = rslt;
+  CACHE_USED_ARR[k] = ++CACHE_CLOCK;
+
+  return;
+}
+
+bool
+bucketTake(u32 * tokens, u32 * ts, u32 rate, u32 burst); // the host's sends are limited too
+
+/*
+ * Summary:     Hands out the time-stamp for a (r)esult packet the host sends.
+ *              Several may leave within the same millisecond (a heartbeat and
+ *              votes for older versions), so each is one past the last at least
+ *              and the boards' seen-windows tell them apart.
+ * Parameters:  None.
+ * Return:      Time-stamp for the packet.
+ */
+u32
+hostStamp()
+{
+  u32 now = millis();
+
+  if ((s32) (now - HOST_STAMP) <= 0) // not past the last one yet
+    now = HOST_STAMP + 1;
+
+  HOST_STAMP = now;
+
+  return now;
+}
+
+/*
+ * Summary:     Looks up the (v)ersion report record of a calculation version.
+ * Parameters:  u32 calculation version.
+ * Return:      Index of the record, INVALID if it was overwritten already.
+ */
+u32
+convFind(u32 calc_ver)
+{
+  for (u32 k = 0; k < CONV_SIZE; ++k)
+    if ((0 != calc_ver) && (calc_ver == CONV_VER_ARR[k]))
+      return k;
+
+  return INVALID;
+}
+
+/*
+ * Summary:     Looks up the ballot box of an older calculation version.
+ * Parameters:  u32 calculation version.
+ * Return:      Index of the ballot box, INVALID if the version has none.
+ */
+u32
+boxFind(u32 calc_ver)
+{
+  for (u32 b = 0; b < BALLOT_BOXES; ++b)
+    if ((0 != BOX_VER_ARR[b]) && (calc_ver == BOX_VER_ARR[b]))
+      return b;
+
+  return INVALID;
+}
+
+/*
+ * Summary:     Looks up the ballot box of the oldest calculation version.
+ * Parameters:  None.
+ * Return:      Index of the ballot box, INVALID if every box is free.
+ */
+u32
+boxOldest()
+{
+  u32 j = INVALID;
+
+  for (u32 b = 0; b < BALLOT_BOXES; ++b)
+    if ((0 != BOX_VER_ARR[b]) && ((INVALID == j) || (BOX_VER_ARR[b]
+        < BOX_VER_ARR[j])))
+      j = b;
+
+  return j;
+}
+
+/*
+ * Summary:     Looks up a ballot among the candidates of a ballot box through
+ *              their hash index (see candidateFind).
+ * Parameters:  u32 index of the ballot box, u32 ballot.
+ * Return:      Index of the candidate, INVALID if nobody voted for it yet.
+ */
+u32
+boxCandidateFind(u32 b, u32 BALLOT)
+{
+  for (u32 h = nodeHash(BALLOT); 0 != BOX_CANDIDATE_HASH_ARR[b][h]; h = (h
+      + 1) % NODE_HASH_SIZE)
+    if (BALLOT == BOX_CANDIDATE_ARR[b][BOX_CANDIDATE_HASH_ARR[b][h] - 1])
+      return BOX_CANDIDATE_HASH_ARR[b][h] - 1;
+
+  return INVALID;
+}
+
+/*
+ * Summary:     Adds a candidate of a ballot box to the box's hash index.
+ * Parameters:  u32 index of the ballot box, u32 index of the candidate.
+ * Return:      None.
+ */
+void
+boxCandidateIndex(u32 b, u32 k)
+{
+  u32 h = nodeHash(BOX_CANDIDATE_ARR[b][k]);
+
+  while (0 != BOX_CANDIDATE_HASH_ARR[b][h]) // probe for a free slot
+    h = (h + 1) % NODE_HASH_SIZE;
+
+  BOX_CANDIDATE_HASH_ARR[b][h] = k + 1;
+
+  return;
+}
+
+/*
+ * Summary:     Counts a vote for a candidate of a ballot box and keeps the
+ *              box's leader up to date, in O(1) (see tallyAdd).
+ * Parameters:  u32 index of the ballot box, u32 index of the candidate.
+ * Return:      None.
+ */
+void
+boxTallyAdd(u32 b, u32 k)
+{
+  u32 v = ++BOX_CANDIDATE_VOTES_ARR[b][k];
+
+  if (k == BOX_LEAD_ARR[b]) // the leader pulls further ahead
+    BOX_TOP_ARR[b] = v;
+
+  else if (v > BOX_TOP_ARR[b])
+    { // a new leader; the old one becomes the best of the rest
+      BOX_NEXT_ARR[b] = BOX_TOP_ARR[b];
+      BOX_TOP_ARR[b] = v;
+      BOX_LEAD_ARR[b] = k;
+    }
+
+  else if (v > BOX_NEXT_ARR[b]) // catching up, possibly to a tie
+    BOX_NEXT_ARR[b] = v;
+
+  return;
+}
+
+/*
+ * Summary:     Recounts the leader of a ballot box from scratch, for when votes
+ *              are taken back.
+ * Parameters:  u32 index of the ballot box.
+ * Return:      None.
+ */
+void
+boxRescan(u32 b)
+{
+  BOX_LEAD_ARR[b] = INVALID;
+  BOX_TOP_ARR[b] = 0;
+  BOX_NEXT_ARR[b] = 0;
+
+  for (u32 k = 0; k < BOX_CANDIDATES_ARR[b]; ++k)
+    {
+      if (BOX_CANDIDATE_VOTES_ARR[b][k] > BOX_TOP_ARR[b])
+        {
+          BOX_NEXT_ARR[b] = BOX_TOP_ARR[b];
+          BOX_TOP_ARR[b] = BOX_CANDIDATE_VOTES_ARR[b][k];
+          BOX_LEAD_ARR[b] = k;
+        }
+
+      else if (BOX_CANDIDATE_VOTES_ARR[b][k] > BOX_NEXT_ARR[b])
+        BOX_NEXT_ARR[b] = BOX_CANDIDATE_VOTES_ARR[b][k];
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Takes back the vote of a node that's being evicted from a ballot
+ *              box's tally (see nodeEvict); a box whose majority is final only
+ *              drops the count.
+ * Parameters:  u32 index of the ballot box, u32 index of the node.
+ * Return:      None.
+ */
+void
+boxRetract(u32 b, u32 NODE_INDEX)
+{
+  u32 BALLOT = BOX_VOTE_ARR[b][NODE_INDEX];
+
+  if (0 == BALLOT)
+    return;
+
+  --BOX_VOTES_ARR[b];
+
+  u32 k = boxCandidateFind(b, BALLOT);
+
+  if (BOX_FINAL_ARR[b] || (INVALID == k))
+    return; // the tally is done with, see boxVote
+
+  if (0 == --BOX_CANDIDATE_VOTES_ARR[b][k])
+    { // nobody is left voting for it, so move the last candidate over it
+      u32 last = --BOX_CANDIDATES_ARR[b];
+
+      BOX_CANDIDATE_ARR[b][k] = BOX_CANDIDATE_ARR[b][last];
+      BOX_CANDIDATE_VOTES_ARR[b][k] = BOX_CANDIDATE_VOTES_ARR[b][last];
+      BOX_CANDIDATE_ARR[b][last] = 0;
+      BOX_CANDIDATE_VOTES_ARR[b][last] = 0;
+
+      for (u32 h = 0; h < NODE_HASH_SIZE; ++h)
+        BOX_CANDIDATE_HASH_ARR[b][h] = 0;
+
+      for (u32 c = 0; c < BOX_CANDIDATES_ARR[b]; ++c)
+        boxCandidateIndex(b, c);
+    }
+
+  boxRescan(b);
+
+  return;
+}
+
+/*
+ * Summary:     Notes the majority of a ballot box from its tally, and whether
+ *              it's final (see finalCheck).
+ * Parameters:  u32 index of the ballot box.
+ * Return:      None.
+ */
+void
+boxTally(u32 b)
+{
+  u32 votes = BOX_VOTES_ARR[b];
+  u32 top = BOX_TOP_ARR[b];
+  u32 next = BOX_NEXT_ARR[b];
+  u32 majority = 0;
+
+  if ((votes >= VOTE_COUNT_MIN) && (0 != top)) // same as evalMajority
+    majority = (next == top) ? TIE : BOX_CANDIDATE_ARR[b][BOX_LEAD_ARR[b]];
+
+  u32 k = convFind(BOX_VER_ARR[b]);
+
+  if (INVALID != k) // (v)ersion report
+    CONV_VOTES_ARR[k] = votes;
+
+  if (majority != BOX_MAJORITY_ARR[b])
+    { // the majority changed
+      if (INVALID != k)
+        {
+          if ((0 != majority) && (TIE != majority))
+            CONV_MS_ARR[k] = millis() - BOX_TS_ARR[b];
+
+          CONV_RSLT_ARR[k] = majority;
+        }
+
+      trace(TRACE_MAJORITY, ID_HOST, majority);
+    }
+
+  BOX_MAJORITY_ARR[b] = majority;
+
+  u32 out = ballotsOut(votes);
+
+  if ((0 != majority) && (TIE != majority) && (INVALID != out) && ((top
+      - next) > out))
+    { // not even the ballots still out could change it
+      BOX_FINAL_ARR[b] = true;
+
+      if (INVALID != k)
+        CONV_FINAL_ARR[k] = millis() - BOX_TS_ARR[b];
+
+      trace(TRACE_FINAL, ID_HOST, majority);
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Takes a vote for the older calculation version in a ballot box.
+ * Parameters:  u32 index of the ballot box, u32 index of the node that voted,
+ *              u32 ballot of the node.
+ * Return:      None.
+ */
+void
+boxVote(u32 b, u32 NODE_INDEX, u32 BALLOT)
+{
+  if (0 == BALLOT) // 0 is never a correct answer
+    return;
+
+  else if (0 != BOX_VOTE_ARR[b][NODE_INDEX])
+    return; // Ignore duplicate votes, and changed ones
+
+  BOX_VOTE_ARR[b][NODE_INDEX] = BALLOT; // record the node's ballot
+  ++BOX_VOTES_ARR[b];
+  trace(TRACE_VOTE, ID_NODE_ARR[NODE_INDEX], BALLOT);
+
+  u32 k = convFind(BOX_VER_ARR[b]);
+
+  if (INVALID != k) // (v)ersion report
+    {
+      CONV_VOTES_ARR[k] = BOX_VOTES_ARR[b];
+      CONV_LAST_ARR[k] = millis() - BOX_TS_ARR[b];
+    }
+
+  if (BOX_FINAL_ARR[b]) // the ballot only counts for the strikes
+    return;
+
+  u32 c = boxCandidateFind(b, BALLOT);
+
+  if (INVALID == c) // the ballot is new to the box's candidates
+    {
+      c = BOX_CANDIDATES_ARR[b]++;
+      BOX_CANDIDATE_ARR[b][c] = BALLOT;
+      BOX_CANDIDATE_VOTES_ARR[b][c] = 0;
+      boxCandidateIndex(b, c);
+    }
+
+  boxTallyAdd(b, c);
+  boxTally(b);
+
+  return;
+}
+
+/*
+ * Summary:     Broadcasts the host's vote in a ballot box, in a (r)esult packet
+ *              of the box's calculation version.  The boards remember it as
+ *              the host's last full packet, so the next heartbeat goes out in
+ *              full again.
+ * Parameters:  u32 index of the ballot box.
+ * Return:      None.
+ */
+void
+boxSend(u32 b)
+{
+  if (!bucketTake(&BUCKET_NODE_ARR[0], &BUCKET_TS_NODE_ARR[0], ORIGIN_RATE,
+      ORIGIN_BURST)) // Spam self-safeguard; a full heartbeat sends it again
+    {
+      ++STAT_ARR[STAT_ORIGIN_LIMITED];
+      return;
+    }
+
+  R_PKT PKT_T; // synthesize a new packet
+
+  PKT_T.key.ID = ID_HOST;
+  PKT_T.key.TIME = hostStamp();
+  PKT_T.calc = BOX_CALC_ARR[b];
+  PKT_T.calc_ver = BOX_VER_ARR[b];
+  PKT_T.rslt = BOX_VOTE_ARR[b][0];
+  PKT_T.neighbor = NEIGHBOR_FLAG | WIRE_BINARY | WIRE_LIVENESS | WIRE_BATCH; // for neighbors only
+
+  BRD_R_PKT(&PKT_T, false); // broadcast the packet
+  seenRecord(0, PKT_T.key.TIME); // don't forward it again if it comes back
+  VER_NODE_ARR[0] = 0; // the grid no longer remembers the current vote
+
+  return;
+}
+
+/*
+ * Summary:     Retires a ballot box:  its votes are held against its majority
+ *              for the strikes, and the box is freed up.
+ * Parameters:  u32 index of the ballot box.
+ * Return:      None.
+ */
+void
+boxClose(u32 b)
+{
+  trace(TRACE_RETIRE, BOX_VER_ARR[b], BOX_MAJORITY_ARR[b]);
+  strikeCheck(BOX_VOTE_ARR[b], BOX_MAJORITY_ARR[b]); // evaluate the strikes for my neighbors
+  BOX_VER_ARR[b] = 0;
+
+  return;
+}
+
+/*
+ * Summary:     Retires the ballot boxes that are done, in the order of their
+ *              calculation versions:  a box is done once every active node
+ *              (the host included) voted in it or BALLOT_TIMEOUT passed, and
+ *              the boxes of newer versions wait for it.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+boxRetire()
+{
+  for (u32 b = boxOldest(); INVALID != b; b = boxOldest())
+    {
+      u32 missing = 0; // active nodes that haven't voted
+
+      for (u32 i = 0; i < NODE_COUNT; ++i)
+        if ((0 == BOX_VOTE_ARR[b][i]) && ((0 == i) || ((millis()
+            - TS_HOST_ARR[i]) < IDLE_TIMEOUT)))
+          ++missing;
+
+      if ((0 != missing) && ((millis() - BOX_TS_ARR[b]) < BALLOT_TIMEOUT))
+        return; // still waiting on votes
+
+      boxClose(b);
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Moves the votes of the current calculation version into a ballot
+ *              box as a newer version takes over, so the votes still on their
+ *              way are counted instead of thrown away.  Without a free box, the
+ *              oldest one retires early.  A host vote the grid wasn't told
+ *              about yet goes out right away.  Versions without a calculation
+ *              to vote on aren't boxed and their strikes are evaluated right
+ *              away.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+boxOpen()
+{
+  if ((0 == HOST_CALC_VER) || (0 == (HOST_CALC & WORK_ARG_MASK)))
+    {
+      strikeCheck(VOTE_NODE_ARR, MAJORITY_RSLT); // evaluate the strikes for my neighbors
+      return;
+    }
+
+  u32 b = 0;
+
+  while ((b < BALLOT_BOXES) && (0 != BOX_VER_ARR[b]))
+    ++b; // look for a free box
+
+  if (b >= BALLOT_BOXES)
+    boxClose(b = boxOldest()); // or make room
+
+  BOX_VER_ARR[b] = HOST_CALC_VER;
+  BOX_CALC_ARR[b] = HOST_CALC;
+  BOX_TS_ARR[b] = VER_TS;
+  BOX_MAJORITY_ARR[b] = MAJORITY_RSLT;
+  BOX_FINAL_ARR[b] = MAJORITY_FINAL;
+
+  BOX_VOTES_ARR[b] = VOTE_COUNT; // the tally goes along with the votes
+  BOX_CANDIDATES_ARR[b] = CANDIDATE_COUNT;
+  BOX_LEAD_ARR[b] = TALLY_LEAD;
+  BOX_TOP_ARR[b] = TALLY_TOP;
+  BOX_NEXT_ARR[b] = TALLY_NEXT;
+
+  for (u32 i = 0; i < NODE_CAPACITY; ++i)
+    {
+      BOX_VOTE_ARR[b][i] = VOTE_NODE_ARR[i];
+      BOX_CANDIDATE_ARR[b][i] = CANDIDATE_ARR[i];
+      BOX_CANDIDATE_VOTES_ARR[b][i] = CANDIDATE_VOTES_ARR[i];
+    }
+
+  for (u32 h = 0; h < NODE_HASH_SIZE; ++h)
+    BOX_CANDIDATE_HASH_ARR[b][h] = CANDIDATE_HASH_ARR[h];
+
+  if ((0 != VOTE_NODE_ARR[0]) && ((VER_NODE_ARR[0] != HOST_CALC_VER)
+      || (RSLT_NODE_ARR[0] != VOTE_NODE_ARR[0])))
+    boxSend(b); // the heartbeats won't carry the host's vote any more
+
+  return;
+}
+
+void
+voteCount(u32 NODE_INDEX, u32 BALLOT); // finished calculations vote through it
+
+void
+calcNext(); // and the next calculation is started through this one
+
+/*
+ * Summary:     Wraps up the running calculation job:  the result is timed,
+ *              cached and cast as the host's vote, in the ballot box of its
+ *              calculation version if a newer one came up meanwhile, and the
+ *              next calculation waiting for the host's vote is started.
+ * Parameters:  u32 result of the calculation.
+ * Return:      None.
+ */
+void
+calcDone(u32 rslt)
+{
+  CALC_TIME = millis() - JOB_START;
+  STAT_ARR[STAT_CALC_MS] += CALC_TIME;
+  cacheStore(JOB_CALC, JOB_FAULTY, rslt);
+  JOB_CALC = 0; // the job is over
+
+  u32 b = boxFind(JOB_VER);
+
+  if (JOB_VER == HOST_CALC_VER) // nobody moved on to a newer version meanwhile
+    voteCount(0, rslt);
+
+  else if (INVALID != b) // the version is still taking votes
+    {
+      boxVote(b, 0, rslt);
+      boxSend(b); // the heartbeats carry the current version's vote
+    }
+
+  calcNext();
+
+  return;
+}
+
+/*
+ * Summary:     Alarm running a bounded slice of the calculation job before
+ *              yielding, so heartbeats, forwarding and the table keep going
+ *              while a large calculation is under way.
+ * Parameters:  Time when function was called (handled automagically).
+ * Return:      None.
+ */
+void
+calcSlice(u32 when)
+{
+  if (0 == JOB_CALC) // the job was finished or abandoned
+    return;
+
+  u32 rslt;
+
+  u32 work = JOB_CALC >> WORK_SHIFT;
+  bool ok;
+
+  for (u32 i = 0; i < CALC_SLICE; ++i)
+    if (0 != JOB_CHECK) // verifying a candidate
+      {
+        if (!verifyStep(JOB_TARGET, JOB_CHECK, &ok))
+          continue;
+
+        if (ok)
+          { // vote for it without computing anything else
+            ++STAT_ARR[STAT_VERIFIED];
+            calcDone(JOB_CHECK);
+            return;
+          }
+
+        ++STAT_ARR[STAT_VERIFY_FAILED];
+        JOB_CHECK = 0; // disagreement, compute it after all
+        JOB_POS = 0;
+        JOB_ACC = 0;
+        LEHMER_PHASE = 0;
+      }
+
+    else if (WORK_STEP_ARR[work](JOB_TARGET, &rslt))
+      {
+        calcDone(rslt);
+        return;
+      }
+
+    else if (JOB_IDLE)
+      { // check back later, or as soon as a vote comes in
+        Alarms.set(Alarms.currentAlarmNumber(), millis() + PART_POLL);
+        return;
+      }
+
+  // Schedule the next slice
+  Alarms.set(Alarms.currentAlarmNumber(), millis() + calcSlice_PERIOD);
+
+  return;
+}
+
+/*
+ * Summary:     Runs the workload selected by the top bits of the calculation
+ *              (see WORK_SHIFT) on the argument held by the rest of them.  The
+ *              default one generates the n_th prime number using an incremental
+ *              "Sieve of Eratosthenes" that is kept between calculations (see
+ *              sieveExtend and nthPrime).  More information and explanations
+ *              on the algorithm can be found online.  Results are remembered
+ *              in a small cache keyed by the calculation and the FAULTY flag
+ *              so replayed calculations don't get recomputed.
+ *
+ *              Anything that isn't answered straight away is carried out as a
+ *              job in small slices (see calcSlice), and the host's vote is
+ *              cast through calcDone once it's done.  Starting a calculation
+ *              abandons any job still running, so new calculation versions
+ *              queue up behind the running one through calcNext instead.  With
+ *              VERIFY_MODE, an n_th prime the peers already voted for in the
+ *              current version is verified instead (see verifyStep), and only
+ *              computed if it turns out to be wrong.
+ *
+ *              The nice part of this function is that a different calculation
+ *              can be swapped in for voting pretty easily without changing too
+ *              many things in the architecture:  add a WORK_* index, a row to
+ *              each WORK_*_ARR array and a step to WORK_STEP_ARR.  If you want
+ *              to add more arguments/results, then adjust the (r)esult and
+ *              (c)alculation packet structures accordingly.
+ * Parameters:  a - the workload and argument (e.g. the prime sequence), u32
+ *              calculation version to vote for.
+ * Return:      None.
+ */
+void
+calculate(u32 a, u32 ver)
+{
+  JOB_CALC = 0; // abandon any calculation still running
+  JOB_VER = ver; // the versions up to this one are taken care of
+  ++STAT_ARR[STAT_CALCULATE];
+
+  if ((a & WORK_ARG_MASK) < 1) // invalid calculation
+    {
+      flush(); // take it as a signal to clear out the boards
+      setStatus(OFF); // and to turn off the LED
+      return;
+    }
+
+  if ((a >> WORK_SHIFT) >= WORK_COUNT) // a workload this board doesn't have
+    {
+      logNormal("calculate:  Workload %d is unknown.\n", a >> WORK_SHIFT);
+      return;
+    }
+
+  JOB_CALC = a;
+  JOB_FAULTY = FAULTY;
+  JOB_START = millis(); // time the latency added before the vote goes out
+
+  u32 k = cacheFind(a, FAULTY);
+
+  if (INVALID != k)
+    { // the same calculation was voted on before
+      ++CACHE_HITS;
+      CACHE_USED_ARR[k] = ++CACHE_CLOCK;
+      calcDone(CACHE_RSLT_ARR[k]);
+      return;
+    }
+
+  ++CACHE_MISSES;
+
+  // This adds the faulty factor into the calculation; (p)artitioned
+  // calculations add it to each part instead (see partStep)
+  if (FAULTY && (WORK_PART != (a >> WORK_SHIFT))) // If the button was pressed an odd amount of times
+    JOB_TARGET = (a & WORK_ARG_MASK) + 1; // (n + 1)_th prime, ...
   else
-    setStatus(OFF); // Inadequate amount of IXM's for voting
+    // otherwise
+    JOB_TARGET = a & WORK_ARG_MASK; // n_th prime, ...
+
+  if (JOB_TARGET > WORK_LIMIT_ARR[a >> WORK_SHIFT])
+    JOB_TARGET -= 2; // (n - 1)_th prime, ... at the top of the range
+
+  JOB_CHECK = 0;
+  JOB_PART = INVALID;
+  JOB_IDLE = false;
+  JOB_POS = 0;
+  JOB_ACC = 0;
+  LEHMER_PHASE = 0;
+
+  if (WORK_PART == (a >> WORK_SHIFT))
+    { // deal out the parts, keeping any votes already in
+      partReset();
+      partRank();
+    }
+
+#if PRIME_TABLE
+  if ((WORK_PRIME == (a >> WORK_SHIFT)) && (JOB_TARGET <= PRIME_TABLE_SIZE))
+    { // constant-time answer straight from flash
+      calcDone(PRIME_TABLE_ARR[JOB_TARGET - 1]);
+      return;
+    }
+#endif
+
+#if VERIFY_MODE
+  if ((WORK_PRIME == (a >> WORK_SHIFT)) && (ver == HOST_CALC_VER)
+      && (INVALID != TALLY_LEAD))
+    JOB_CHECK = CANDIDATE_ARR[TALLY_LEAD]; // check the peers' answer first
+#endif
+
+  setStatus(PROCESSING); // blue LED indicates calculation
+  Alarms.set(JOB_ALARM, millis()); // start slicing away at it
+
+  return;
+}
+
+/*
+ * Summary:     Starts the next calculation waiting for the host's vote unless a
+ *              job is running:  the oldest boxed version the host has yet to
+ *              vote on, then the current one.  Versions only go up, so every
+ *              version up to the last job's has been taken care of.  The parts
+ *              of a (p)artitioned calculation are only counted while it's the
+ *              current one, as the other boards move on to the newer version.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+calcNext()
+{
+  if ((0 != JOB_CALC) && (WORK_PART == (JOB_CALC >> WORK_SHIFT)) && (JOB_VER
+      != HOST_CALC_VER))
+    JOB_CALC = 0; // abandon the outdated parts
+
+  if (0 != JOB_CALC) // one job at a time
+    return;
+
+  u32 j = INVALID;
+
+  for (u32 b = 0; b < BALLOT_BOXES; ++b)
+    if ((BOX_VER_ARR[b] > JOB_VER) && (WORK_PART != (BOX_CALC_ARR[b]
+        >> WORK_SHIFT)) && ((INVALID == j) || (BOX_VER_ARR[b]
+        < BOX_VER_ARR[j])))
+      j = b;
+
+  if (INVALID != j)
+    calculate(BOX_CALC_ARR[j], BOX_VER_ARR[j]);
+
+  else if (HOST_CALC_VER > JOB_VER)
+    calculate(HOST_CALC, HOST_CALC_VER);
+
+  return;
+}
+
+/*
+ * Summary:     Adjusts the vote count based on a recent vote.
+ * Parameters:  u32 index of the node that voted, u32 ballot of the node.
+ * Return:      None.
+ */
+void
+voteCount(u32 NODE_INDEX, u32 BALLOT)
+{
+  if (NODE_INDEX < 0)
+    {
+      logNormal("voteCount:  Invalid node index %d", NODE_INDEX);
+      API_ASSERT_GREATER_EQUAL(NODE_INDEX, 0); // blinkcode!
+    }
+
+  if (BALLOT < 0)
+    {
+      logNormal("voteCount:  Invalid ballot %d", BALLOT);
+      API_ASSERT_GREATER_EQUAL(BALLOT, 0); // blinkcode!
+    }
+
+  if (0 == BALLOT) // 0 is never a correct answer
+    return; // But it's not worth blinkcoding over
+
+  else if (BALLOT == VOTE_NODE_ARR[NODE_INDEX])
+    return; // Ignore duplicate votes
+
+  // Invalid vote if I've already voted (didn't flush from a new calculation)
+  else if (0 != VOTE_NODE_ARR[NODE_INDEX])
+    return;
+
+  else if (0 == VOTE_NODE_ARR[NODE_INDEX]) // Haven't voted yet
+    ++VOTE_COUNT; // This is the first vote received
+
+  if (VOTE_COUNT > NODE_COUNT) // Someone voted multiple times
+    {
+      flush(); // Clean out memory
+      calculate(HOST_CALC, HOST_CALC_VER); // Recount our own vote
+      return;
+    }
+
+  VOTE_NODE_ARR[NODE_INDEX] = BALLOT; // record the node's ballot
+  CONV_VOTES_ARR[CONV_HEAD] = VOTE_COUNT; // for the (v)ersion report
+  CONV_LAST_ARR[CONV_HEAD] = millis() - VER_TS;
+  trace(TRACE_VOTE, ID_NODE_ARR[NODE_INDEX], BALLOT);
+
+  if (MAJORITY_FINAL) // the ballot only counts for the strikes
+    {
+      if (0 == NODE_INDEX) // but the host still shows whether it agrees
+        setStatus((BALLOT == MAJORITY_RSLT) ? MAJORITY : MINORITY);
+
+      return;
+    }
+
+  // look to see if the ballot is for an existing candidate
+  u32 k = candidateFind(BALLOT);
+
+  if (INVALID == k) // otherwise the ballot is new to the candidate list
+    { // so add it
+      k = CANDIDATE_COUNT++;
+      CANDIDATE_ARR[k] = BALLOT; // Add the new candidate to the nominations list
+      candidateIndex(k);
+    }
+
+  tallyAdd(k); // Give the candidate a vote
+
+  evalMajority(); //Reevaluate the majority with every different ballot
+
+  return;
+}
+
+/*
+ * Summary:     Marsaglia's xorshift generator, for heartbeat jitter.
+ * Parameters:  None.
+ * Return:      Next pseudo-random u32.
+ */
+u32
+beatRandom()
+{
+  BEAT_SEED ^= BEAT_SEED << 13;
+  BEAT_SEED ^= BEAT_SEED >> 17;
+  BEAT_SEED ^= BEAT_SEED << 5;
+
+  return BEAT_SEED;
+}
+
+/*
+ * Summary:     Picks the interval to the next heartbeat.  While a new
+ *              calculation version converges (for CONVERGE_PERIOD at most, or
+ *              until every known node voted or the majority is final) the
+ *              heartbeats speed up; once the grid is stable they back off,
+ *              doubling up to an interval that grows with the grid's size, and
+ *              are jittered so boards don't flood in lockstep.  The idle
+ *              timeout follows the stable interval so backed-off boards aren't
+ *              taken for idle ones.
+ * Parameters:  None.
+ * Return:      Time until the next heartbeat (ms).
+ */
+u32
+beatNext()
+{
+  BEAT_STABLE = 2 * pingAll_PERIOD * ((NODE_COUNT + BEAT_NODES - 1)
+      / BEAT_NODES);
+
+  if (BEAT_STABLE > BEAT_MAX)
+    BEAT_STABLE = BEAT_MAX;
+
+  IDLE_TIMEOUT = IDLE / pingAll_PERIOD * BEAT_STABLE;
+
+  if ((0 != HOST_CALC_VER) && (VOTE_COUNT < NODE_COUNT) && !MAJORITY_FINAL
+      && ((millis() - VER_TS) < CONVERGE_PERIOD))
+    { // converging: beat quickly, and promptly
+      BEAT_PERIOD = ((BEAT_STABLE / 4) > BEAT_MIN) ? (BEAT_STABLE / 4)
+          : BEAT_MIN;
+      return BEAT_PERIOD;
+    }
+
+  BEAT_PERIOD = ((2 * BEAT_PERIOD) < BEAT_STABLE) ? (2 * BEAT_PERIOD)
+      : BEAT_STABLE; // back off
+
+  // +/- 1/8 of the interval
+  return BEAT_PERIOD - (BEAT_PERIOD / 8) + (beatRandom() % (BEAT_PERIOD / 4));
+}
+
+/*
+ * Summary:     Notes a new calculation version and brings the next heartbeat
+ *              forward, so its vote gets out without waiting out a backed-off
+ *              interval.
+ * Parameters:  None.
+ * Return:      None.
+ */
+void
+beatConverge()
+{
+  VER_TS = millis();
+
+  if (BEAT_PERIOD > BEAT_MIN)
+    Alarms.set(BEAT_ALARM, millis() + BEAT_MIN);
+
+  return;
+}
+
+/*
+ * Summary:     Starts the (v)ersion report record of a new calculation version,
+ *              overwriting the oldest one.
+ * Parameters:  u32 calculation, u32 calculation version.
+ * Return:      None.
+ */
+void
+convStart(u32 calc, u32 calc_ver)
+{
+  CONV_HEAD = (CONV_HEAD + 1) % CONV_SIZE;
+  CONV_VER_ARR[CONV_HEAD] = calc_ver;
+  CONV_CALC_ARR[CONV_HEAD] = calc;
+  CONV_MS_ARR[CONV_HEAD] = INVALID; // no majority yet
+  CONV_RSLT_ARR[CONV_HEAD] = 0;
+  CONV_FINAL_ARR[CONV_HEAD] = INVALID; // not final yet
+  CONV_LAST_ARR[CONV_HEAD] = INVALID; // no vote yet
+  CONV_VOTES_ARR[CONV_HEAD] = 0;
+  CONV_NODES_ARR[CONV_HEAD] = NODE_COUNT;
+  CONV_RX_ARR[CONV_HEAD] = 0;
+  CONV_TX_ARR[CONV_HEAD] = 0;
+
+  return;
+}
+
+/*
+ * Summary:     Records the run time of a reflex handler in the histogram.
+ *              Handlers mostly take well under a millisecond, so they are
+ *              timed in microseconds.
+ * Parameters:  u32 run time (us).
+ * Return:      None.
+ */
+void
+reflexTime(u32 us)
+{
+  u32 i = 0;
+
+  while ((i < (REFLEX_HIST_SIZE - 1)) && (us >= ((u32) 8 << i)))
+    ++i; // find the first bucket the run time fits under
+
+  ++REFLEX_HIST_ARR[i];
+  ++STAT_ARR[STAT_REFLEX];
+  STAT_ARR[STAT_REFLEX_US] += us;
 
   return;
 }
 
 /*
- * Summary:     Currently generates the n_th prime number using the well-known
- *              "Sieve of Atkins" algorithm.  More information and explanations
- *              on the algorithm can be found online.
- *
- *              The nice part of this function is that a different calculation
- *              can be swapped in for voting pretty easily without changing too
- *              many things in the architecture.  If you want to add more
- *              arguments/results, then adjust the (r)esult and (c)alculation
- *              packet structures accordingly.
- * Parameters:  n - the prime sequence to generate.
- * Return:      The n_th prime number.
+ * Summary:     Times a reflex handler from its declaration to its return.
+ * Contains:    u32 start time-stamp.
  */
-u32
-calculate(u32 a)
+struct REFLEX_TIMER
 {
-  if (a < 1) // invalid calculation
-    {
-      flush(); // take it as a signal to clear out the boards
-      setStatus(OFF); // and to turn off the LED
-      return 0;
-    }
+  u32 start;
 
-  setStatus(PROCESSING); // blue LED indicates calculation
-
-  u32 b;
-  u32 c;
-  u32 i;
-  u32 j;
-  u32 k;
+  REFLEX_TIMER() :
+    start(micros())
+  {
+  }
 
-  // This adds the faulty factor into the calculation
-  if (FAULTY) // If the button was pressed an odd amount of times
-    b = a + 1; // (n + 1)_th prime
-  else
-    // otherwise
-    b = a; // n_th prime
+  ~REFLEX_TIMER()
+  {
+    reflexTime(micros() - start);
+  }
+};
 
-  // three embedded FOR-loops = efficiency hell
-  for (i = 3; i < PRIME_ARR_THRESHOLD; ++i)
-    {
-      c = 0;
+/*
+ * Summary:     Token bucket rate limiter:  refills the bucket for the time since
+ *              its last refill, then takes a token out of it if there is one.
+ *              Tokens are kept in 1/1000ths so a rate in tokens per second
+ *              refills "rate" of them every millisecond.  Time-stamps are
+ *              compared by difference so millis() rolling over is harmless,
+ *              and a bucket that has never been used starts out full.
+ * Parameters:  u32 pointer to the bucket's tokens, u32 pointer to its last
+ *              refill time-stamp, u32 rate (tokens per second), u32 burst
+ *              (most tokens the bucket holds).
+ * Return:      True if a token was taken, false if the packet should be dropped.
+ */
+bool
+bucketTake(u32 * tokens, u32 * ts, u32 rate, u32 burst)
+{
+  u32 now = millis();
+  u32 elapsed = now - *ts;
 
-      for (i = 0; i < PRIME_ARR_THRESHOLD; ++i)
-        sieve[i] = 0;
+  *ts = now;
 
-      for (j = 2; j * j <= i; j++)
-        if (!sieve[j])
-          for (k = j + j; k < i; k += j)
-            sieve[k] = 1;
+  if (elapsed >= ((burst * 1000) / rate)) // long enough to fill it up
+    *tokens = burst * 1000;
+  else if ((*tokens + elapsed * rate) > (burst * 1000))
+    *tokens = burst * 1000;
+  else
+    *tokens += elapsed * rate;
 
-      for (j = 2; j < i; j++)
-        {
-          if (!sieve[j])
-            ++c;
-          if (b == c)
-            return j;
-        }
-    }
+  if (*tokens < 1000)
+    return false;
 
-  return 0;
+  *tokens -= 1000;
+  return true;
 }
 
 /*
- * Summary:     Adjusts the vote count based on a recent vote.
- * Parameters:  u32 index of the node that voted, u32 ballot of the node.
+ * Summary:     Handles a received (r)esult packet, whichever encoding it came
+ *              in.  Packet information is logged and result is logged for the
+ *              specific calculation.
+ * Parameters:  (r)esult packet, u8 face it was received on, bool whether it
+ *              was rebuilt from a (l)iveness packet.
  * Return:      None.
  */
 void
-voteCount(u32 NODE_INDEX, u32 BALLOT)
+receiveR(struct R_PKT *PKT_R, u8 face, bool live)
 {
-  if (NODE_INDEX < 0)
-    {
-      logNormal("voteCount:  Invalid node index %d", NODE_INDEX);
-      API_ASSERT_GREATER_EQUAL(NODE_INDEX, 0); // blinkcode!
-    }
+  u32 NODE_INDEX; // index holder for if log is valid
 
-  if (BALLOT < 0)
+  ++CONV_RX_ARR[CONV_HEAD]; // for the (v)ersion report
+  ++STAT_ARR[STAT_R_PARSED];
+  trace(TRACE_RX, PKT_R->key.ID, PKT_R->key.TIME);
+
+  u32 nodes = (NODE_COUNT > FACE_NODES_MIN) ? NODE_COUNT : FACE_NODES_MIN;
+
+  // Handle floods coming through a face, duplicates and all, before any
+  // work goes into them
+  if (!bucketTake(&BUCKET_FACE_ARR[face], &BUCKET_TS_FACE_ARR[face],
+      FACE_RATE * nodes, FACE_BURST * nodes))
     {
-      logNormal("voteCount:  Invalid ballot %d", BALLOT);
-      API_ASSERT_GREATER_EQUAL(BALLOT, 0); // blinkcode!
+      ++STAT_ARR[STAT_FACE_LIMITED];
+      return;
     }
 
-  if (0 == BALLOT) // 0 is never a correct answer
-    return; // But it's not worth blinkcoding over
+  // only log properly formatted packets
+  else if (TABLE_FULL == (NODE_INDEX = log(PKT_R->key.ID, PKT_R->key.TIME)))
+    { // can't count its vote, but the rest of the grid may have room for it
+      ++STAT_ARR[STAT_TABLE_FULL];
 
-  else if (BALLOT == VOTE_NODE_ARR[NODE_INDEX])
-    return; // Ignore duplicate votes
+      if (overflowSeen(PKT_R->key.ID, PKT_R->key.TIME))
+        return;
 
-  // Invalid vote if I've already voted (didn't flush from a new calculation)
-  else if (0 != VOTE_NODE_ARR[NODE_INDEX])
-    return;
+      PKT_R->neighbor = 0; // not to be taken for the host's neighbor
+      FWD_R_PKT(PKT_R, face, live);
+      return;
+    }
 
-  else if (0 == VOTE_NODE_ARR[NODE_INDEX]) // Haven't voted yet
-    ++VOTE_COUNT; // This is the first vote received
+  else if (INVALID == NODE_INDEX)
+    {
+      ++SUP_FACE_ARR[face]; // count the flooding we just avoided
+      return; // Don't continue if this packet has been received before
+    }
 
-  if (VOTE_COUNT > NODE_COUNT) // Someone voted multiple times
+  // Handle packet spammers
+  else if (!bucketTake(&BUCKET_NODE_ARR[NODE_INDEX],
+      &BUCKET_TS_NODE_ARR[NODE_INDEX], ORIGIN_RATE, ORIGIN_BURST))
     {
-      flush(); // Clean out memory
-      voteCount(0, calculate(HOST_CALC)); // Recount our own vote
-      return;
+      ++STAT_ARR[STAT_ORIGIN_LIMITED];
+      return; // Don't continue if this IXM is spamming packets right now.
     }
 
-  // look to see if the ballot is for an existing candidate
-  u32 k = linearSearch(CANDIDATE_ARR, CANDIDATE_COUNT + 1, BALLOT);
+  u32 b = boxFind(PKT_R->calc_ver); // older versions may still take votes
+
+  if ((PKT_R->calc_ver < HOST_CALC_VER) && ((INVALID == b) || (PKT_R->calc
+      != BOX_CALC_ARR[b])))
+    {
+      ++STAT_ARR[STAT_OLD_VER];
+      return; // Don't continue if this is an old calculation version
+    }
 
-  if (INVALID != k) // if so, give him a vote
-    ++CANDIDATE_VOTES_ARR[k];
+  else if (0xffffffff == PKT_R->calc_ver)
+    logNormal("Calculation version overflow.\n");
 
-  else // otherwise the ballot is new to the candidate list
-    { // so add it
-      k = CANDIDATE_COUNT++; // Give him a vote
-      CANDIDATE_ARR[k] = BALLOT; // Add the new candidate to the nominations list
-      ++CANDIDATE_VOTES_ARR[k]; // Give the candidate a vote
+  if (!live && (PKT_R->calc_ver >= VER_NODE_ARR[NODE_INDEX]))
+    { // Remember the node's latest vote state to fill in its (l)iveness
+      // packets, a late vote on a boxed version doesn't roll it back
+      CALC_NODE_ARR[NODE_INDEX] = PKT_R->calc;
+      VER_NODE_ARR[NODE_INDEX] = PKT_R->calc_ver;
+      RSLT_NODE_ARR[NODE_INDEX] = PKT_R->rslt;
     }
 
-  VOTE_NODE_ARR[NODE_INDEX] = BALLOT; // record the node's ballot
+  if (PKT_R->neighbor & NEIGHBOR_FLAG)
+    { // If this a neighboring node
+      FACE_CAPS_ARR[face] = PKT_R->neighbor; // Remember what it understands
+      PKT_R->neighbor = 0; // Reset the flags before forwarding
+      NEIGHBORS_ARR[face] = PKT_R->key.ID; // And remember the ID
+    }
 
-  evalMajority(); //Reevaluate the majority with every different ballot
+  // If all the hoops have been jumped through
+  FWD_R_PKT(PKT_R, face, live); // Forward the packet
+
+  if (PKT_R->calc_ver < HOST_CALC_VER) // Older version still taking votes?
+    boxVote(b, NODE_INDEX, PKT_R->rslt);
+
+  else if (PKT_R->calc_ver == HOST_CALC_VER) // Same result?
+    // Update the results from packets with proper calculation versions
+    voteCount(NODE_INDEX, PKT_R->rslt);
+
+  else if (PKT_R->calc_ver > HOST_CALC_VER) // New calculation version?
+    { // perform standard procedures
+      boxOpen(); // keep taking votes for the version it takes over from
+      flush(); // clear out my records for the new voting session
+      convStart(PKT_R->calc, PKT_R->calc_ver); // and start a new report record
+      voteCount(NODE_INDEX, PKT_R->rslt); // Remember the node's vote
+      HOST_CALC = PKT_R->calc; // Remember the new calculation
+      HOST_CALC_VER = PKT_R->calc_ver; // Remember the new calculation version
+      beatConverge(); // speed up the heartbeats while the vote converges
+      calcNext(); // calculation occurs here, once the older ones are done
+    }
 
   return;
 }
 
 /*
- * Summary:     Handles (r)esult packet reflex.  Packet information is logged and
- *              result is logged for the specific calculation.
+ * Summary:     Handles (r)esult packet reflex (text encoding).
  * Parameters:  (r)esult packet.
  * Return:      None.
  */
 void
 r_handler(u8 * packet)
 {
+  REFLEX_TIMER timer; // for the reflex run time histogram
   R_PKT PKT_R;
 
   if (packetScanf(packet, "%Zr%z\n", R_ZScanner, &PKT_R) != 3)
     {
+      ++STAT_ARR[STAT_R_REJECTED];
       logNormal("r_handler:  Failed at %d\n", packetCursor(packet));
       return; // No harm done so no blinkcoding necessary
     }
 
-  u32 NODE_INDEX; // index holder for if log is valid
+  receiveR(&PKT_R, packetSource(packet), false);
 
-  // only log properly formatted packets
-  if (INVALID == (NODE_INDEX = log(PKT_R.key.ID, PKT_R.key.TIME)))
-    return; // Don't continue if this packet has been received before
+  return;
+}
 
-  // Handle packet spammers
-  else if (PC_NODE_ARR[NODE_INDEX] > (PKT_R.key.TIME / 1000))
+/*
+ * Summary:     Handles (b)inary (r)esult packet reflex.  Only neighbors that
+ *              advertised WIRE_BINARY are sent these, see sendR.
+ * Parameters:  (b)inary packet.
+ * Return:      None.
+ */
+void
+b_handler(u8 * packet)
+{
+  REFLEX_TIMER timer; // for the reflex run time histogram
+  R_PKT PKT_R;
+
+  if (packetScanf(packet, "%Zb%z\n", R_BScanner, &PKT_R) != 3)
     {
-      // Decrease the amount of pings recorded; "spammer amnesty" of sorts.
-      PC_NODE_ARR[NODE_INDEX] -= 2;
-      return; // Don't continue if this IXM is spamming packets right now.
+      ++STAT_ARR[STAT_R_REJECTED];
+      logNormal("b_handler:  Failed at %d\n", packetCursor(packet));
+      return; // No harm done so no blinkcoding necessary
     }
 
-  else if (PKT_R.calc_ver < HOST_CALC_VER)
-    return; // Don't continue if this is an old calculation version
+  receiveR(&PKT_R, packetSource(packet), false);
 
-  else if (0xffffffff == PKT_R.calc_ver)
-    logNormal("Calculation version overflow.\n");
+  return;
+}
 
-  if (PKT_R.neighbor)
-    { // If this a neighboring node
-      PKT_R.neighbor = 0; // Reset the flag before forwarding
-      NEIGHBORS_ARR[packetSource(packet)] = PKT_R.key.ID; // And remember the ID
+/*
+ * Summary:     Handles (m)ulti-record packet reflex:  a count character and
+ *              that many (b)inary records, each handled like its own packet.
+ * Parameters:  (m)ulti-record packet.
+ * Return:      None.
+ */
+void
+m_handler(u8 * packet)
+{
+  REFLEX_TIMER timer; // for the reflex run time histogram
+  R_PKT PKT_R;
+  u8 count;
+
+  if ((packetScanf(packet, "m%c", &count) != 2) || (count < WIRE_DIGIT)
+      || (count > (WIRE_DIGIT + BATCH_MAX)))
+    {
+      ++STAT_ARR[STAT_R_REJECTED];
+      logNormal("m_handler:  Failed at %d\n", packetCursor(packet));
+      return; // No harm done so no blinkcoding necessary
     }
 
-  // If all the hoops have been jumped through
-  FWD_R_PKT(&PKT_R, packetSource(packet)); // Forward the packet
+  for (u32 i = 0; i < (u32) (count - WIRE_DIGIT); ++i)
+    {
+      if (packetScanf(packet, "%Z%z", R_BScanner, &PKT_R) != 1)
+        {
+          ++STAT_ARR[STAT_R_REJECTED];
+          logNormal("m_handler:  Failed at %d\n", packetCursor(packet));
+          return; // Records before the bad one are handled already
+        }
 
-  if (PKT_R.calc_ver == HOST_CALC_VER) // Same result?
-    // Update the results from packets with proper calculation versions
-    voteCount(NODE_INDEX, PKT_R.rslt);
+      receiveR(&PKT_R, packetSource(packet), false);
+    }
 
-  else if (PKT_R.calc_ver > HOST_CALC_VER) // New calculation version?
-    { // perform standard procedures
-      strikeCheck(); // evaluate the strikes for my neighbors
-      flush(); // clear out my records for the new voting session
-      voteCount(NODE_INDEX, PKT_R.rslt); // Remember the node's vote
-      HOST_CALC = PKT_R.calc; // Remember the new calculation
-      HOST_CALC_VER = PKT_R.calc_ver; // Remember the new calculation version
-      voteCount(0, calculate(HOST_CALC)); // calculation occurs here
+  return;
+}
+
+/*
+ * Summary:     Handles (l)iveness packet reflex:  a heartbeat whose sender's
+ *              vote state didn't change since its last full (r)esult packet.
+ *              The rest of the packet is filled in from that full packet (or
+ *              left empty if none arrived yet) and handled like any other.
+ * Parameters:  (l)iveness packet.
+ * Return:      None.
+ */
+void
+l_handler(u8 * packet)
+{
+  REFLEX_TIMER timer; // for the reflex run time histogram
+  R_PKT PKT_R;
+
+  if (packetScanf(packet, "l%t,%d,%d\n", &PKT_R.key.ID, &PKT_R.key.TIME,
+      &PKT_R.neighbor) != 7)
+    {
+      ++STAT_ARR[STAT_R_REJECTED];
+      logNormal("l_handler:  Failed at %d\n", packetCursor(packet));
+      return; // No harm done so no blinkcoding necessary
     }
 
+  u32 i = nodeFind(PKT_R.key.ID);
+
+  PKT_R.calc = (INVALID != i) ? CALC_NODE_ARR[i] : 0;
+  PKT_R.calc_ver = (INVALID != i) ? VER_NODE_ARR[i] : 0;
+  PKT_R.rslt = (INVALID != i) ? RSLT_NODE_ARR[i] : 0;
+
+  receiveR(&PKT_R, packetSource(packet), true);
+
   return;
 }
 
@@ -678,43 +3638,124 @@ r_handler(u8 * packet)
 void
 c_handler(u8 * packet)
 {
+  REFLEX_TIMER timer; // for the reflex run time histogram
   C_PKT PKT_R;
 
   if (packetScanf(packet, "%Zc%z\n", C_ZScanner, &PKT_R) != 3)
     {
+      ++STAT_ARR[STAT_C_REJECTED];
       logNormal("c_handler:  Failed at %d\n", packetCursor(packet));
       return;
     }
 
-  if (PKT_R.calc < 0)
+  if (PKT_R.work >= WORK_COUNT)
     {
-      logNormal("c_handler:  Input %d must be a non-negative integer.\n",
-          PKT_R.calc);
+      ++STAT_ARR[STAT_C_REJECTED];
+      logNormal("c_handler:  Workload %d is unknown.\n", PKT_R.work);
       return;
     }
 
-  if (PKT_R.calc > PRIME_THRESHOLD)
+  if (PKT_R.calc > WORK_LIMIT_ARR[PKT_R.work])
     {
-      logNormal("c_handler:  Value %d is higher than the threshold %d (%d).\n",
-          PKT_R.calc, PRIME_THRESHOLD, PRIME_ARR_THRESHOLD - 1);
+      ++STAT_ARR[STAT_C_REJECTED];
+      logNormal("c_handler:  Value %d is higher than the %s threshold %d.\n",
+          PKT_R.calc, WORK_NAME_ARR[PKT_R.work], WORK_LIMIT_ARR[PKT_R.work]);
       return;
     }
 
-  strikeCheck(); // evaluate the strikes for my neighbors
+  ++STAT_ARR[STAT_C_PARSED];
+  boxOpen(); // keep taking votes for the version it takes over from
   flush(); // clear out my records for the new voting session
 
   R_PKT PKT_T; // synthesize a new packet
   ++HOST_CALC_VER;
-  HOST_CALC = PKT_R.calc;
+  HOST_CALC = (PKT_R.work << WORK_SHIFT) | PKT_R.calc; // workload and argument
+  beatConverge(); // speed up the heartbeats while the vote converges
+  convStart(HOST_CALC, HOST_CALC_VER); // and start a new report record
   PKT_T.key.ID = ID_HOST;
-  PKT_T.key.TIME = millis();
+  PKT_T.key.TIME = hostStamp();
   PKT_T.calc = HOST_CALC;
   PKT_T.calc_ver = HOST_CALC_VER;
   PKT_T.rslt = VOTE_NODE_ARR[0];
+  PKT_T.neighbor = 0;
+  seenRecord(0, PKT_T.key.TIME); // don't forward it again if it comes back
 
   // If all the hoops have been jumped through
-  FWD_R_PKT(&PKT_T, packetSource(packet)); // Forward the packet
-  voteCount(0, calculate(HOST_CALC)); // calculation occurs here
+  FWD_R_PKT(&PKT_T, packetSource(packet), false); // Forward the packet
+  calcNext(); // calculation occurs here, once the older ones are done
+
+  return;
+}
+
+/*
+ * Summary:     Handles (n)eighbor packet reflex:  remembers where the neighbor
+ *              on that face stands in the spanning tree.  These packets are
+ *              never forwarded.
+ * Parameters:  (n)eighbor packet.
+ * Return:      None.
+ */
+void
+n_handler(u8 * packet)
+{
+  REFLEX_TIMER timer; // for the reflex run time histogram
+  N_PKT PKT_R;
+
+  if (packetScanf(packet, "n%t,%t,%d,%t\n", &PKT_R.ID, &PKT_R.root,
+      &PKT_R.hops, &PKT_R.parent) != 9)
+    {
+      logNormal("n_handler:  Failed at %d\n", packetCursor(packet));
+      return; // No harm done so no blinkcoding necessary
+    }
+
+  if (PKT_R.hops >= NODE_CAPACITY)
+    return; // no path through the grid is that long, and hops + 1 would wrap
+
+  u8 face = packetSource(packet);
+
+  NEIGHBORS_ARR[face] = PKT_R.ID; // remember the neighbor
+  TREE_ROOT_ARR[face] = PKT_R.root;
+  TREE_HOPS_ARR[face] = PKT_R.hops;
+  TREE_CHILD_ARR[face] = (ID_HOST == PKT_R.parent) && (ID_HOST != PKT_R.ID);
+  TREE_TS_ARR[face] = millis();
+
+  treeUpdate();
+
+  return;
+}
+
+/*
+ * Summary:     Handles (p)art packet reflex:  takes in a vote on a part of the
+ *              current (p)artitioned calculation and passes it on if it's new.
+ * Parameters:  (p)art packet.
+ * Return:      None.
+ */
+void
+p_handler(u8 * packet)
+{
+  REFLEX_TIMER timer; // for the reflex run time histogram
+  P_PKT PKT_R;
+
+  if (packetScanf(packet, "p%t,%d,%d,%d\n", &PKT_R.ID, &PKT_R.calc_ver,
+      &PKT_R.part, &PKT_R.count) != 9)
+    {
+      logNormal("p_handler:  Failed at %d\n", packetCursor(packet));
+      return; // No harm done so no blinkcoding necessary
+    }
+
+  if ((PKT_R.calc_ver != HOST_CALC_VER) || (WORK_PART != (HOST_CALC
+      >> WORK_SHIFT)) || (PKT_R.part > ((HOST_CALC & WORK_ARG_MASK)
+      / partSpan(HOST_CALC & WORK_ARG_MASK))))
+    return; // not a part of the current calculation
+
+  partReset();
+
+  if (!partVote(PKT_R.ID, PKT_R.part, PKT_R.count))
+    return;
+
+  partSend(PKT_R.ID, PKT_R.part, PKT_R.count, packetSource(packet));
+
+  if (JOB_IDLE) // the job may be waiting on just this
+    Alarms.set(JOB_ALARM, millis());
 
   return;
 }
@@ -742,8 +3783,30 @@ printTable(u32 when)
       TERMINAL_FACE,
       "\n\n\n\n\n\n\n\n\n\n\n\n\n+===============================================================+\n");
   facePrintf(TERMINAL_FACE,
-      "|CALCULATION: %4d     HOST TIME: %010d                    |\n",
-      HOST_CALC, HOST_TIME);
+      "|CALC: %10d,%d    HOST TIME: %010d   BEAT: %5dms    |\n",
+      HOST_CALC & WORK_ARG_MASK, HOST_CALC >> WORK_SHIFT, HOST_TIME,
+      BEAT_PERIOD);
+  facePrintf(TERMINAL_FACE,
+      "|CALC TIME: %6dms   CACHE HITS: %6d   CACHE MISSES: %6d|\n",
+      CALC_TIME, CACHE_HITS, CACHE_MISSES);
+  facePrintf(TERMINAL_FACE,
+      "|FORWARDED   0:%7d   1:%7d   2:%7d   3:%7d      |\n",
+      FWD_FACE_ARR[0], FWD_FACE_ARR[1], FWD_FACE_ARR[2], FWD_FACE_ARR[3]);
+  facePrintf(TERMINAL_FACE,
+      "|SUPPRESSED  0:%7d   1:%7d   2:%7d   3:%7d      |\n",
+      SUP_FACE_ARR[0], SUP_FACE_ARR[1], SUP_FACE_ARR[2], SUP_FACE_ARR[3]);
+  facePrintf(TERMINAL_FACE, // K = 1024us
+      "|REFLEX US      <8:%6d   <16:%6d   <32:%6d   <64:%6d|\n",
+      REFLEX_HIST_ARR[0], REFLEX_HIST_ARR[1], REFLEX_HIST_ARR[2],
+      REFLEX_HIST_ARR[3]);
+  facePrintf(TERMINAL_FACE,
+      "|             <128:%6d  <256:%6d  <512:%6d   <1K:%6d|\n",
+      REFLEX_HIST_ARR[4], REFLEX_HIST_ARR[5], REFLEX_HIST_ARR[6],
+      REFLEX_HIST_ARR[7]);
+  facePrintf(TERMINAL_FACE,
+      "|              <2K:%6d   <4K:%6d   <8K:%6d   8K+:%6d|\n",
+      REFLEX_HIST_ARR[8], REFLEX_HIST_ARR[9], REFLEX_HIST_ARR[10],
+      REFLEX_HIST_ARR[11]);
   facePrintf(TERMINAL_FACE,
       "+---------------------------------------------------------------+\n");
   facePrintf(TERMINAL_FACE,
@@ -762,6 +3825,10 @@ printTable(u32 when)
       == MAJORITY_RSLT))
     facePrintf(TERMINAL_FACE,
         "|MAJORITY: --                                                   |\n");
+  else if (MAJORITY_FINAL)
+    facePrintf(TERMINAL_FACE,
+        "|MAJORITY: %4d   (final)                                       |\n",
+        MAJORITY_RSLT);
   else
     facePrintf(TERMINAL_FACE,
         "|MAJORITY: %4d                                                 |\n",
@@ -789,6 +3856,165 @@ t_handler(u8 * packet)
   return;
 }
 
+/*
+ * Summary:     Handles (v)ersion report packet reflex:  prints a CSV record for
+ *              each of the last CONV_SIZE calculation versions, oldest first,
+ *              back out of the face that asked.  Columns are the host ID, the
+ *              version, the calculation, whether the host is FAULTY, the time
+ *              from the new version to the last change of majority (-1 if
+ *              there was none), votes counted, peak node table occupancy,
+ *              records received and sent during the version, the last
+ *              majority (0 if none, TIE in a tie), and the time from the new
+ *              version to the majority turning final and to the last vote
+ *              counted (-1 if none), for how long stragglers lag behind the
+ *              decision.  Older versions keep counting votes while their
+ *              ballot boxes are open, see boxOpen.  Dumps of several boards
+ *              can be concatenated, the header line aside.
+ * Parameters:  (v)ersion report packet.
+ * Return:      None.
+ */
+void
+v_handler(u8 * packet)
+{
+  if (packetScanf(packet, "v\n") != 2)
+    return;
+
+  u8 face = packetSource(packet);
+
+  facePrintf(face,
+      "id,ver,calc,faulty,ms,votes,nodes,rx,tx,majority,final_ms,last_ms\n");
+
+  for (u32 i = 1; i <= CONV_SIZE; ++i)
+    {
+      u32 k = (CONV_HEAD + i) % CONV_SIZE; // oldest first
+
+      if (0 == CONV_VER_ARR[k])
+        continue; // never used
+
+      facePrintf(face, "%t,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n", ID_HOST,
+          CONV_VER_ARR[k], CONV_CALC_ARR[k], FAULTY, CONV_MS_ARR[k],
+          CONV_VOTES_ARR[k], CONV_NODES_ARR[k], CONV_RX_ARR[k],
+          CONV_TX_ARR[k], CONV_RSLT_ARR[k], CONV_FINAL_ARR[k],
+          CONV_LAST_ARR[k]);
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Prints the counter registry out of a face, one CSV line per
+ *              counter:  "S", the host ID, the counter's name and its value.
+ *              The per-face forward and suppression counts and the cache
+ *              counts follow the registry.  Lines start with "S" so a board
+ *              collecting them can pick them up with a reflex of its own.
+ * Parameters:  u8 face.
+ * Return:      None.
+ */
+void
+statDump(u8 face)
+{
+  for (u32 i = 0; i < STAT_COUNT; ++i)
+    facePrintf(face, "S%t,%s,%d\n", ID_HOST, STAT_NAME_ARR[i], STAT_ARR[i]);
+
+  for (u32 i = 0; i < FACE_COUNT; ++i)
+    {
+      facePrintf(face, "S%t,forwarded%d,%d\n", ID_HOST, i, FWD_FACE_ARR[i]);
+      facePrintf(face, "S%t,suppressed%d,%d\n", ID_HOST, i, SUP_FACE_ARR[i]);
+    }
+
+  facePrintf(face, "S%t,cache_hits,%d\n", ID_HOST, CACHE_HITS);
+  facePrintf(face, "S%t,cache_misses,%d\n", ID_HOST, CACHE_MISSES);
+
+  return;
+}
+
+/*
+ * Summary:     Streams the counter registry on interval while STAT_PERIOD is set.
+ * Parameters:  Time when function was called (handled automagically).
+ * Return:      None.
+ */
+void
+statStream(u32 when)
+{
+  if (0 == STAT_PERIOD) // streaming was turned off
+    return;
+
+  statDump(STAT_FACE);
+
+  // schedule the next dump
+  Alarms.set(Alarms.currentAlarmNumber(), when + STAT_PERIOD);
+
+  return;
+}
+
+/*
+ * Summary:     Handles (s)tatistics packet reflex:  "s" dumps the counter
+ *              registry back out of the face that asked, "sN" streams it out of
+ *              that face every N ms (to a terminal or a collecting board) and
+ *              "s0" stops the streaming.
+ * Parameters:  (s)tatistics packet.
+ * Return:      None.
+ */
+void
+s_handler(u8 * packet)
+{
+  u32 period = 0;
+
+  if (packetScanf(packet, "s%d\n", &period) == 3)
+    { // start (or stop) streaming
+      STAT_FACE = packetSource(packet);
+      STAT_PERIOD = period;
+
+      if (0 != STAT_PERIOD)
+        Alarms.set(STAT_ALARM, millis());
+
+      return;
+    }
+
+  statDump(packetSource(packet)); // just the once
+
+  return;
+}
+
+/*
+ * Summary:     Handles (d)rain packet reflex:  prints the trace events recorded
+ *              since the last drain back out of the face that asked, oldest
+ *              first, as "D" lines of CSV:  host ID, host time-stamp, event
+ *              (TRACE_*), board ID and value.  The first line carries the host
+ *              time-stamp at the drain and the count of events that were
+ *              overwritten before they could be drained, to line the traces of
+ *              several boards up into one timeline.
+ * Parameters:  (d)rain packet.
+ * Return:      None.
+ */
+void
+d_handler(u8 * packet)
+{
+  if (packetScanf(packet, "d\n") != 2)
+    return;
+
+  u8 face = packetSource(packet);
+  u32 lost = 0;
+
+  if ((TRACE_HEAD - TRACE_TAIL) > TRACE_SIZE)
+    { // the ring buffer went round since the last drain
+      lost = TRACE_HEAD - TRACE_TAIL - TRACE_SIZE;
+      TRACE_TAIL = TRACE_HEAD - TRACE_SIZE;
+    }
+
+  facePrintf(face, "D%t,%d,now,%d\n", ID_HOST, millis(), lost);
+
+  for (; TRACE_TAIL != TRACE_HEAD; ++TRACE_TAIL)
+    {
+      u32 i = TRACE_TAIL & (TRACE_SIZE - 1);
+
+      facePrintf(face, "D%t,%d,%c,%t,%d\n", ID_HOST, TRACE_TIME_ARR[i],
+          TRACE_EVENT_ARR[i], TRACE_ID_ARR[i], TRACE_VAL_ARR[i]);
+    }
+
+  return;
+}
+
 /*
  * Summary:     Handles (x) packet reflex:  Reboot signal.
  * Parameters:  'x' packet.
@@ -820,26 +4046,53 @@ heartBeat(u32 when)
   R_PKT PKT_T;
 
   PKT_T.key.ID = ID_HOST;
-  PKT_T.key.TIME = millis();
+  PKT_T.key.TIME = hostStamp();
   PKT_T.calc = HOST_CALC;
   PKT_T.calc_ver = HOST_CALC_VER;
   PKT_T.rslt = VOTE_NODE_ARR[0];
-  PKT_T.neighbor = 1;
+  PKT_T.neighbor = NEIGHBOR_FLAG | WIRE_BINARY | WIRE_LIVENESS | WIRE_BATCH; // for neighbors only
 
-  if (PC_NODE_ARR[0] > (PKT_T.key.TIME / 1000)) // Spam self-safeguard
+  if (!bucketTake(&BUCKET_NODE_ARR[0], &BUCKET_TS_NODE_ARR[0], ORIGIN_RATE,
+      ORIGIN_BURST)) // Spam self-safeguard
     {
-      PC_NODE_ARR[0] -= 2; // self "spammer amnesty"
+      ++STAT_ARR[STAT_ORIGIN_LIMITED];
+      Alarms.set(Alarms.currentAlarmNumber(), when + beatNext());
       return;
     }
 
-  BRD_R_PKT(&PKT_T); // broadcast the packet
+  if (TREE_ROUTING)
+    treeAnnounce(); // let the neighbors know where the host stands
+
+  // Only tell the grid the host is alive if its vote state didn't change,
+  // with a full packet every FULL_BEATS for boards that missed the last one
+  bool live = (LIVE_COUNT + 1 < FULL_BEATS) && (CALC_NODE_ARR[0]
+      == PKT_T.calc) && (VER_NODE_ARR[0] == PKT_T.calc_ver)
+      && (RSLT_NODE_ARR[0] == PKT_T.rslt);
+
+  if (LIVE_COUNT + 1 >= FULL_BEATS) // boards that missed the host's votes
+    for (u32 b = 0; b < BALLOT_BOXES; ++b) // for older versions
+      if ((0 != BOX_VER_ARR[b]) && (0 != BOX_VOTE_ARR[b][0]))
+        boxSend(b); // hear them again, before the heartbeat they remember
+
+  if (live)
+    ++LIVE_COUNT;
+
+  else
+    { // remember what the grid was last told in full
+      LIVE_COUNT = 0;
+      CALC_NODE_ARR[0] = PKT_T.calc;
+      VER_NODE_ARR[0] = PKT_T.calc_ver;
+      RSLT_NODE_ARR[0] = PKT_T.rslt;
+    }
+
+  BRD_R_PKT(&PKT_T, live); // broadcast the packet
   ++PC_NODE_ARR[0]; // update recent host ping count
-  TS_NODE_ARR[0] = PKT_T.key.TIME; // update recent host ping times
+  seenRecord(0, PKT_T.key.TIME); // update recent host ping times
   TS_HOST_ARR[0] = PKT_T.key.TIME;
 
   for (u32 i = 1; i < NODE_COUNT; ++i)
     { // evaluate non-host IXM activity/inactivity
-      ACTIVE_NODE_ARR[i] = (((TS_HOST_ARR[0] - TS_HOST_ARR[i]) < IDLE) ? 'A'
+      ACTIVE_NODE_ARR[i] = (((TS_HOST_ARR[0] - TS_HOST_ARR[i]) < IDLE_TIMEOUT) ? 'A'
           : 'I'); // For displaying activity/inactivity on the table
 
       if ('I' == ACTIVE_NODE_ARR[i])
@@ -849,8 +4102,16 @@ heartBeat(u32 when)
         }
     }
 
+  finalCheck(); // the grid may have been discovered since the last vote
+
+  for (u32 b = 0; b < BALLOT_BOXES; ++b) // and for the older versions
+    if ((0 != BOX_VER_ARR[b]) && !BOX_FINAL_ARR[b])
+      boxTally(b);
+
+  boxRetire(); // done with the older versions?
+
   // Schedule the next heartbeat
-  Alarms.set(Alarms.currentAlarmNumber(), when + pingAll_PERIOD);
+  Alarms.set(Alarms.currentAlarmNumber(), when + beatNext());
 
   return;
 }
@@ -915,15 +4176,30 @@ setup()
 {
   // Initialize reflexes
   Body.reflex('r', r_handler);
+  Body.reflex('b', b_handler);
+  Body.reflex('n', n_handler);
+  Body.reflex('p', p_handler);
+  Body.reflex('l', l_handler);
+  Body.reflex('m', m_handler);
   Body.reflex('c', c_handler);
   Body.reflex('t', t_handler);
+  Body.reflex('v', v_handler);
+  Body.reflex('s', s_handler);
+  Body.reflex('d', d_handler);
   Body.reflex('x', x_handler);
 
   // Initialize host values
   ID_NODE_ARR[0] = ID_HOST;
+  nodeIndex(0);
+  TREE_ROOT = ID_HOST;
   ACTIVE_NODE_ARR[0] = 'A';
 
-  Alarms.set(Alarms.create(heartBeat), pingAll_PERIOD); // Start the heartbeats
+  BEAT_SEED = ID_HOST | 1; // boards jitter differently, and never from 0
+  BEAT_ALARM = Alarms.create(heartBeat);
+  Alarms.set(BEAT_ALARM, pingAll_PERIOD); // Start the heartbeats
+  JOB_ALARM = Alarms.create(calcSlice); // Calculations run on this alarm
+  BATCH_ALARM = Alarms.create(batchFlush); // Batched records leave on this one
+  STAT_ALARM = Alarms.create(statStream); // Counters are streamed on this one
   faultSignal((FAULTY ? BODY_RGB_RED_PIN : BODY_RGB_GREEN_PIN)); // HE LIVES!
 
   return;
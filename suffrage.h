@@ -18,14 +18,127 @@
 
 #define INVALID 0xffffffff
 #define TIE 0xfffffffe
+#define TABLE_FULL 0xfffffffd // log():  no room in the node table for the sender
 #define OFF 0xffffffff
 #define MINORITY 0 // Red LED
 #define MAJORITY 1 // Green LED
 #define PROCESSING 2 // Blue LED
-const u32 PRIME_THRESHOLD = 1000; // Accept nothing higher than the 1000th prime
-const u32 PRIME_ARR_THRESHOLD = 7920; // 1000th prime is 7919
+#define NEIGHBOR_FLAG 1 // (r)esult packet came straight from a neighbor
+#define WIRE_BINARY 2 // sender of the (r)esult packet understands (b)inary ones
+#define WIRE_LIVENESS 4 // sender of the (r)esult packet understands (l)iveness ones
+#define WIRE_BATCH 8 // sender of the (r)esult packet understands (m)ulti-record ones
+#define WIRE_DIGIT '0' // lowest character of the (b)inary packet encoding
+#define STAT_R_PARSED 0 // (r)esult records parsed, whatever the encoding
+#define STAT_R_REJECTED 1 // (r)esult packets that failed to parse
+#define STAT_C_PARSED 2 // (c)alculation packets accepted
+#define STAT_C_REJECTED 3 // (c)alculation packets that failed to parse or were too high
+#define STAT_DUPLICATE 4 // records dropped by log() as duplicate or stale
+#define STAT_ORIGIN_LIMITED 5 // records dropped by the rate limit of their origin
+#define STAT_OLD_VER 6 // records of older calculation versions
+#define STAT_CALCULATE 7 // calculate() invocations
+#define STAT_CALC_MS 8 // cumulative calculation time (ms)
+#define STAT_REFLEX 9 // timed reflex runs
+#define STAT_REFLEX_US 10 // cumulative timed reflex run time (us)
+#define STAT_FACE_LIMITED 11 // records dropped by the rate limit of their face
+#define STAT_VERIFIED 12 // leading candidates verified instead of computed (VERIFY_MODE)
+#define STAT_VERIFY_FAILED 13 // leading candidates that failed verification
+#define STAT_PART_VOTES 14 // (p)art votes taken in, the host's own included
+#define STAT_PART_SEGMENTS 15 // segments sieved for (p)artitioned calculations
+#define STAT_TABLE_FULL 16 // records from senders the node table had no room for
+#define STAT_COUNT 17 // count of counters in the registry
+#define TRACE_RX 'r' // record received: sender ID, sender time-stamp
+#define TRACE_FWD 'f' // record forwarded: sender ID, sender time-stamp
+#define TRACE_DUP 'd' // record dropped as duplicate/stale: sender ID, time-stamp
+#define TRACE_VOTE 'v' // vote counted: voter ID, ballot
+#define TRACE_MAJORITY 'm' // majority changed: host ID, new majority (or TIE)
+#define TRACE_STRIKE 's' // strike given: node ID, strike count
+#define TRACE_REBOOT 'x' // neighbor powered off for a reboot: neighbor ID, face
+#define TRACE_RETIRE 'o' // ballot box retired: calculation version, its majority
+#define TRACE_FINAL 'q' // majority final, the ballots still out can't change it: host ID, majority
+#define LEHMER_PHI 1 // Meissel-Lehmer phase:  summing up the terms of phi(x, a)
+#define LEHMER_P2 2 // Meissel-Lehmer phase:  sweeping segments for the P2 terms
+#define LEHMER_DONE 3 // Meissel-Lehmer phase:  pi(x) is known
+#define WORK_PRIME 0 // workload:  n_th prime
+#define WORK_PI 1 // workload:  count of primes up to n
+#define WORK_CRC 2 // workload:  CRC-32 of n generated bytes
+#define WORK_HASH 3 // workload:  n chained FNV-1a rounds
+#define WORK_PART 4 // workload:  count of primes up to n, split across the grid
+#define WORK_COUNT 5 // count of workloads in the registry
+#define WORK_SHIFT 28 // calculation bits from here up select the workload
+#define WORK_ARG_MASK 0x0fffffff // calculation bits below WORK_SHIFT hold its argument
+#ifndef NODE_CAPACITY
+#define NODE_CAPACITY 32 // IXM nodes the node table holds; idle ones make way past it
+#endif
+#define NODE_HASH_SIZE (4 * NODE_CAPACITY) // slots of the node ID hash index
+#ifndef TREE_ROUTING
+#define TREE_ROUTING 0 // 1 = forward along a spanning tree instead of flooding
+#endif
+#ifndef PART_REPLICAS
+#define PART_REPLICAS 2 // boards counting each part of a (p)artitioned calculation
+#endif
+#ifndef VERIFY_MODE
+#define VERIFY_MODE 0 // 1 = verify the leading candidate before computing the n_th prime
+#endif
+#ifndef BATCH_MODE
+#define BATCH_MODE 1 // 0 = send every record on its own, (m)ulti-record packets are still read
+#endif
+#ifndef EXPECTED_BOARDS
+#define EXPECTED_BOARDS 0 // boards the grid is built of, if known; 0 = as discovered
+#endif
+#ifndef SEGMENT_WORDS
+#define SEGMENT_WORDS 128 // segment buffer size; each word covers 64 integers
+#endif
+#ifndef PRIME_TABLE
+#define PRIME_TABLE 0 // 1 = answer the first PRIME_TABLE_SIZE primes from flash
+#endif
+const u32 PRIME_THRESHOLD = 10000; // Accept nothing higher than the 10000th prime
+const u32 PRIME_ARR_THRESHOLD = 104730; // 10000th prime is 104729
+const u32 SIEVE_WORDS = (PRIME_ARR_THRESHOLD / 2 + 31) / 32; // one bit per odd
+const u32 PRIME_SEGMENTED_THRESHOLD = 1000000; // segmented sieve goes this far
+const u32 PRIME_LEHMER_THRESHOLD = 203280221; // p_n still fits in 32 bits this far
+const u32 PHI_SMALL = 4; // leading primes phi() is tabulated for
+const u32 PHI_PRIMORIAL = 210; // product of the first PHI_SMALL primes
+const u32 PHI_TOTIENT = 48; // integers below PHI_PRIMORIAL coprime to it
+const u32 PHI_PRIMES = 259; // primes listed for phi(), p_258 = 1627 covers any u32
+const u32 PI_STRIDE = 8 * SEGMENT_WORDS * 64; // integers between prime count checkpoints
+const u32 PI_INDEX_SIZE = 256; // prime count checkpoints kept, up to 16M with 128-word segments
+const u32 PART_COUNT = 32; // parts a (p)artitioned calculation is split into
+const u32 PART_SLOTS = 4; // votes remembered per part
+const u32 PART_QUORUM = PART_REPLICAS / 2 + 1; // matching votes that settle a part
+const u32 WORK_CHUNK = 4096; // bytes/rounds a CRC or hash step works through
+const u32 SEEN_WINDOW = 4; // recent packet time-stamps remembered per node
+const u32 OVERFLOW_SIZE = 16; // recent records remembered from senders the node table can't hold
+const u32 CALC_SLICE = 4; // sieve blocks/segments worked through per calculation slice
+const u32 VERIFY_DIVISORS = 512; // odd trial divisors tried per verification step
+const u16 calcSlice_PERIOD = 1; // interval between calculation slices
+const u32 REFLEX_HIST_SIZE = 12; // power-of-two buckets of reflex run time (us)
+const u32 TRACE_SIZE = 64; // events in the trace ring buffer (a power of two)
+const u32 CONV_SIZE = 8; // calculation versions remembered for the (v)ersion report
+const u32 BALLOT_BOXES = 3; // older calculation versions still taking votes
+const u32 CACHE_SIZE = 8; // calculation results remembered across versions
+const u32 PRIME_TABLE_SIZE = 1000; // primes generated at compile-time (PRIME_TABLE);
+                                   // no more than 1000:  PRIME_TABLE_1000 lists
+                                   // that many and the templates' build time
+                                   // climbs steeply past it (see TableNthPrime)
 const u16 IDLE = 5000; // limit for absence of ping until IXM node is considered idle
-const u16 pingAll_PERIOD = 1000; // interval for heartbeat
+const u16 pingAll_PERIOD = 1000; // interval for heartbeat (nominal, see BEAT_PERIOD)
+const u16 BEAT_MIN = 500; // shortest heartbeat interval, while a calculation converges
+const u16 BEAT_MAX = 4000; // longest heartbeat interval, for large stable grids
+const u32 BEAT_NODES = 16; // nodes per pingAll_PERIOD of half the stable interval
+const u16 CONVERGE_PERIOD = 5000; // time a new calculation version counts as converging
+const u32 DISCOVERY_BEATS = 2; // stable heartbeat intervals without a new node until the grid counts as discovered
+const u16 BALLOT_TIMEOUT = 10000; // time from a new calculation version to its ballot box closing
+const u32 ORIGIN_RATE = 4; // (r)esult records per second allowed from each origin
+const u32 ORIGIN_BURST = 8; // (r)esult records an origin may send back-to-back
+const u32 FACE_RATE = 4; // records per second allowed on a face, per known node
+const u32 FACE_BURST = 8; // records a face may take back-to-back, per known node
+const u32 FACE_NODES_MIN = 16; // known nodes the face limits assume at least, for discovery
+const u16 BATCH_WINDOW = 5; // time records wait on a face to leave together
+const u32 BATCH_MAX = 4; // records per (m)ulti-record packet
+const u32 FULL_BEATS = 4; // heartbeats per full (r)esult packet while nothing changes
+const u16 PART_TIMEOUT = 2000; // silence before a board counts the parts nobody settled
+const u16 PART_POLL = 100; // interval for checking on the parts while waiting
+const u16 TREE_TIMEOUT = 3000; // limit for absence of (n)eighbor packets (per pingAll_PERIOD)
 const u16 printTable_PERIOD = 500; // interval for refreshing the table
 const u16 FAULT_STATUS_PERIOD = 500; // interval for LED flash initialization
 const u16 reboot_PERIOD = 5000; // power off time during reboot
@@ -38,35 +151,227 @@ bool FAULTY = false; // Determines if the calculation should be erroneous
 u32 HOST_CALC = 0; // n_th prime to be calculated
 u32 HOST_CALC_VER = 0; // n_th prime calculation version
 u32 MAJORITY_RSLT = 0; // n_th prime running majority result
+bool MAJORITY_FINAL = false; // the ballots still out can no longer change the majority
 u32 NODE_COUNT = 1; // count of IXM nodes, always includes host IXM
 u32 CANDIDATE_COUNT = 0; // count of candidates to vote for
+u32 TALLY_LEAD = INVALID; // index of the candidate with the most votes
+u32 TALLY_TOP = 0; // vote-count of the leading candidate
+u32 TALLY_NEXT = 0; // highest vote-count of the other candidates; a tie if TALLY_TOP
+u32 BEAT_PERIOD = pingAll_PERIOD; // current heartbeat interval
+u32 BEAT_STABLE = pingAll_PERIOD; // heartbeat interval the grid backs off to
+u32 IDLE_TIMEOUT = IDLE; // limit for absence of ping, scaled with BEAT_STABLE
+u32 BEAT_ALARM = 0; // alarm the heartbeats run on
+u32 BEAT_SEED = 1; // xorshift state for heartbeat jitter
+u32 VER_TS = 0; // host time-stamp of the last new calculation version
+u32 JOIN_TS = 0; // host time-stamp of the last node added to the node table
+u32 LIVE_COUNT = 0; // (l)iveness heartbeats sent since the last full one
+u32 HOST_STAMP = 0; // last time-stamp the host put on a (r)esult packet
 u32 TERMINAL_FACE = INVALID; // terminal face for table printout and clean UI
 u32 VOTE_COUNT = 0; // count of IXM votes so far
+u32 SIEVE_LIMIT = 0; // every integer below this has been sieved
+u32 PRIME_CURSOR_W = 0; // sieve word holding the last prime located
+u32 PRIME_CURSOR_N = 0; // count of odd primes in the sieve words before it
+u32 SEGMENT_LOW = 0; // first integer of the segment holding the last prime
+u32 SEGMENT_COUNT = 0; // count of odd primes below SEGMENT_LOW
+u32 PI_INDEX_TOP = 1; // prime count checkpoints known, from 0 up
+u32 LEHMER_PHASE = 0; // phase of the running Meissel-Lehmer count (LEHMER_*), 0 = none
+u32 LEHMER_A = 0; // pi(x^(1/3)), the primes phi(x, a) leaves out
+u32 LEHMER_I = 0; // index of the next prime to handle in the current phase
+u32 LEHMER_P = 0; // prime of index LEHMER_I while sweeping for the P2 terms
+u32 LEHMER_SUM = 0; // partial result of the Meissel-Lehmer count
+u32 CALC_TIME = 0; // duration (ms) of the last calculation
+u32 JOB_CALC = 0; // calculation the running job works on; 0 if there is none
+u32 JOB_VER = 0; // calculation version the running job will vote for
+u32 JOB_TARGET = 0; // argument the running job works on (n_th prime, ...)
+u32 JOB_CHECK = 0; // candidate the running job verifies first; 0 if none
+u32 JOB_PART = INVALID; // part the running job is counting; INVALID if none
+bool JOB_IDLE = false; // running job is waiting on (p)art votes, not working
+u32 PART_VER = 0; // calculation version the (p)art votes are for
+u32 PART_RANK = 0; // host's rank among the active boards' IDs, for the parts
+u32 PART_BOARDS = 1; // active boards the parts are dealt out to
+u32 PART_TS = 0; // host time-stamp of the last new (p)art vote
+u32 JOB_POS = 0; // progress of the running job, meaning depends on the workload
+u32 JOB_ACC = 0; // partial result of the running job, e.g. a CRC or a count
+u32 JOB_START = 0; // time-stamp of when the running job started
+u32 JOB_ALARM = 0; // alarm running the calculation slices
+u32 BATCH_ALARM = 0; // alarm sending out the queued (m)ulti-record packets
+bool JOB_FAULTY = false; // FAULTY flag the running job was started with
+u32 TRACE_HEAD = 0; // count of trace events ever recorded
+u32 TRACE_TAIL = 0; // count of trace events at the last drain
+u32 CONV_HEAD = 0; // slot of the current calculation version's record
+u32 STAT_ALARM = 0; // alarm streaming the counter registry
+u32 STAT_FACE = INVALID; // face the counter registry is streamed out of
+u32 STAT_PERIOD = 0; // interval for streaming the counter registry, 0 = off
+u32 CACHE_CLOCK = 0; // use-stamp source for the result cache
+u32 CACHE_HITS = 0; // calculations answered from the result cache
+u32 CACHE_MISSES = 0; // calculations that had to be computed
 
-char sieve[PRIME_ARR_THRESHOLD] =
-  { 0 }; // array used for storing prime calculations
-char ACTIVE_NODE_ARR[32] =
+u32 sieve[SIEVE_WORDS] =
+  { 0 }; // odd-only bitset for prime calculations; bit i set = 2i+1 composite
+u32 segment[SEGMENT_WORDS] =
+  { 0 }; // odd-only bitset for the segment starting at SEGMENT_LOW
+u32 PART_ID_ARR[PART_COUNT][PART_SLOTS] =
+  { { 0 } }; // board IDs that voted for the respective parts
+u32 PART_RSLT_ARR[PART_COUNT][PART_SLOTS] =
+  { { 0 } }; // their prime counts plus one; 0 = free slot
+u32 PART_MAJORITY_ARR[PART_COUNT] =
+  { 0 }; // settled prime count plus one of the respective parts; 0 = unsettled
+u32 PI_INDEX_ARR[PI_INDEX_SIZE] =
+  { 0 }; // count of odd primes below each multiple of PI_STRIDE
+u8 PHI_SMALL_ARR[PHI_PRIMORIAL] =
+  { 0 }; // phi(m, PHI_SMALL) for the respective m
+u16 PHI_PRIME_ARR[PHI_PRIMES] =
+  { 0 }; // i_th prime at index i (0 unused); empty until phiInit
+char ACTIVE_NODE_ARR[NODE_CAPACITY] =
   { 'I' }; // list of active nodular IXM's
-u16 PC_NODE_ARR[32] =
+u16 PC_NODE_ARR[NODE_CAPACITY] =
   { 0 }; // ping count for nodes
-u32 ID_NODE_ARR[32] =
+u32 ID_NODE_ARR[NODE_CAPACITY] =
   { 0 }; // list of nodular IXM ID's
-u32 CANDIDATE_ARR[32] =
+u16 NODE_HASH_ARR[NODE_HASH_SIZE] =
+  { 0 }; // node index + 1 of the ID hashed to each slot; 0 = free
+u16 CANDIDATE_HASH_ARR[NODE_HASH_SIZE] =
+  { 0 }; // candidate index + 1 of the ballot hashed to each slot; 0 = free
+u32 CANDIDATE_ARR[NODE_CAPACITY] =
   { 0 }; // list of the possible values to vote for
-u32 VOTE_NODE_ARR[32] =
+u32 VOTE_NODE_ARR[NODE_CAPACITY] =
   { 0 }; // n_th prime calculation result for respective nodes
-u32 TS_HOST_ARR[32] =
+u32 BOX_VER_ARR[BALLOT_BOXES] =
+  { 0 }; // calculation version of the respective ballot boxes; 0 = free
+u32 BOX_CALC_ARR[BALLOT_BOXES] =
+  { 0 }; // calculation of the respective ballot boxes
+u32 BOX_TS_ARR[BALLOT_BOXES] =
+  { 0 }; // host time-stamp of when their calculation versions came up
+u32 BOX_MAJORITY_ARR[BALLOT_BOXES] =
+  { 0 }; // majority result of the respective ballot boxes (TIE, 0 = none)
+bool BOX_FINAL_ARR[BALLOT_BOXES] =
+  { false }; // whether the majority of the respective ballot boxes is final
+u32 BOX_VOTE_ARR[BALLOT_BOXES][NODE_CAPACITY] =
+  { { 0 } }; // n_th prime calculation result for respective nodes, per box
+u32 BOX_VOTES_ARR[BALLOT_BOXES] =
+  { 0 }; // ballots in the respective ballot boxes
+u32 BOX_CANDIDATES_ARR[BALLOT_BOXES] =
+  { 0 }; // count of candidates in the respective ballot boxes
+u32 BOX_LEAD_ARR[BALLOT_BOXES] =
+  { 0 }; // index of the leading candidate of the respective ballot boxes
+u32 BOX_TOP_ARR[BALLOT_BOXES] =
+  { 0 }; // vote-count of the leading candidate, per box
+u32 BOX_NEXT_ARR[BALLOT_BOXES] =
+  { 0 }; // highest vote-count of the other candidates, per box
+u32 BOX_CANDIDATE_ARR[BALLOT_BOXES][NODE_CAPACITY] =
+  { { 0 } }; // list of the values voted for, per box
+u32 BOX_CANDIDATE_VOTES_ARR[BALLOT_BOXES][NODE_CAPACITY] =
+  { { 0 } }; // vote-count of the respective candidates, per box
+u16 BOX_CANDIDATE_HASH_ARR[BALLOT_BOXES][NODE_HASH_SIZE] =
+  { { 0 } }; // candidate index + 1 of the ballot hashed to each slot, per box
+u32 CALC_NODE_ARR[NODE_CAPACITY] =
+  { 0 }; // calculation from the last full (r)esult packet of respective nodes
+u32 VER_NODE_ARR[NODE_CAPACITY] =
+  { 0 }; // calculation version from the last full (r)esult packet of nodes
+u32 RSLT_NODE_ARR[NODE_CAPACITY] =
+  { 0 }; // result from the last full (r)esult packet of respective nodes
+u32 BUCKET_NODE_ARR[NODE_CAPACITY] =
+  { 0 }; // rate limit tokens (1/1000ths) left for respective nodes
+u32 BUCKET_TS_NODE_ARR[NODE_CAPACITY] =
+  { 0 }; // host time-stamp of the last refill of the respective buckets
+u32 TS_HOST_ARR[NODE_CAPACITY] =
   { 0 }; // last-received time-stamp of nodes from host times
-u32 TS_NODE_ARR[32] =
+u32 TS_NODE_ARR[NODE_CAPACITY] =
   { 0 }; // last-received time-stamp of nodes from respective node packets
-u32 CANDIDATE_VOTES_ARR[32] =
+u32 SEEN_NODE_ARR[NODE_CAPACITY][SEEN_WINDOW] =
+  { { 0 } }; // recent packet time-stamps of nodes, for duplicate suppression
+u8 SEEN_HEAD_ARR[NODE_CAPACITY] =
+  { 0 }; // slot of the oldest time-stamp in the respective seen-windows
+u32 OVERFLOW_ID_ARR[OVERFLOW_SIZE] =
+  { 0 }; // sender IDs of recent records the node table had no room for
+u32 OVERFLOW_TIME_ARR[OVERFLOW_SIZE] =
+  { 0 }; // and their time-stamps, so their duplicates are still told apart
+u32 OVERFLOW_HEAD = 0; // slot the next of those records goes in
+u32 CANDIDATE_VOTES_ARR[NODE_CAPACITY] =
   { 0 }; // vote-count for the respective results
-u32 STRIKES_NODE_ARR[32] =
+u32 STRIKES_NODE_ARR[NODE_CAPACITY] =
   { 0 }; // strike-count for respective nodes
+const char * const STAT_NAME_ARR[STAT_COUNT] = // names of the counters
+      { "r_parsed", "r_rejected", "c_parsed", "c_rejected", "duplicate",
+          "origin_limited", "old_ver", "calculate", "calc_ms", "reflex",
+          "reflex_us", "face_limited", "verified", "verify_failed",
+          "part_votes", "part_segments", "table_full" };
+const char * const WORK_NAME_ARR[WORK_COUNT] = // names of the workloads
+      { "prime", "pi", "crc", "hash", "part" };
+const u32 WORK_LIMIT_ARR[WORK_COUNT] = // highest argument of the workloads
+      { PRIME_LEHMER_THRESHOLD, WORK_ARG_MASK, 16000000, 16000000, WORK_ARG_MASK };
+const u8 WORK_ARG_BITS_ARR[WORK_COUNT] = // significant bits of the arguments
+      { 28, 28, 24, 24, 28 };
+const u8 WORK_RSLT_BITS_ARR[WORK_COUNT] = // significant bits of the results
+      { 32, 24, 32, 32, 24 };
+const u32 WORK_COST_ARR[WORK_COUNT] = // estimated cost, host ns per 1000 argument units
+      { 114, 9, 5800, 6100, 3700 }; // at the limit; prime and pi grow slower than
+                                    // linear, part is split over the boards
+u32 STAT_ARR[STAT_COUNT] =
+  { 0 }; // counter registry, see the STAT_* indices
+u32 TRACE_TIME_ARR[TRACE_SIZE] =
+  { 0 }; // host time-stamp of the respective trace events
+u8 TRACE_EVENT_ARR[TRACE_SIZE] =
+  { 0 }; // kind of the respective trace events (TRACE_*)
+u32 TRACE_ID_ARR[TRACE_SIZE] =
+  { 0 }; // board ID the respective trace events are about
+u32 TRACE_VAL_ARR[TRACE_SIZE] =
+  { 0 }; // value of the respective trace events
+u32 CONV_VER_ARR[CONV_SIZE] =
+  { 0 }; // calculation version of the respective records
+u32 CONV_CALC_ARR[CONV_SIZE] =
+  { 0 }; // calculation of the respective records
+u32 CONV_MS_ARR[CONV_SIZE] =
+  { 0 }; // time from the new version to the last change of majority
+u32 CONV_RSLT_ARR[CONV_SIZE] =
+  { 0 }; // last majority of the respective versions (TIE, 0 = none)
+u32 CONV_FINAL_ARR[CONV_SIZE] =
+  { 0 }; // time from the new version to its majority turning final
+u32 CONV_LAST_ARR[CONV_SIZE] =
+  { 0 }; // time from the new version to the last vote counted
+u32 CONV_VOTES_ARR[CONV_SIZE] =
+  { 0 }; // votes counted for the respective versions
+u32 CONV_NODES_ARR[CONV_SIZE] =
+  { 0 }; // peak node table occupancy during the respective versions
+u32 CONV_RX_ARR[CONV_SIZE] =
+  { 0 }; // records received during the respective versions
+u32 CONV_TX_ARR[CONV_SIZE] =
+  { 0 }; // records sent during the respective versions
+u32 CACHE_CALC_ARR[CACHE_SIZE] =
+  { 0 }; // calculation of the respective cached results
+bool CACHE_FAULTY_ARR[CACHE_SIZE] =
+  { false }; // FAULTY flag the respective results were calculated with
+u32 CACHE_RSLT_ARR[CACHE_SIZE] =
+  { 0 }; // cached calculation results; 0 marks a free entry
+u32 CACHE_USED_ARR[CACHE_SIZE] =
+  { 0 }; // use-stamp of the respective results, least recent is evicted
+u32 REFLEX_HIST_ARR[REFLEX_HIST_SIZE] =
+  { 0 }; // reflex handler run times; bucket i counts runs under 8 << i us
 u32 NEIGHBORS_ARR[FACE_COUNT] =
   { 0 }; // keep track of neighboring nodes; black array
 u32 REBOOT_ARR[FACE_COUNT] =
   { 0 }; // keep track of faces to be rebooted
+u32 TREE_ROOT = 0; // ID of the spanning tree root (lowest active ID)
+u32 TREE_HOPS = 0; // hops from the host to the spanning tree root
+u32 TREE_PARENT = INVALID; // face towards the spanning tree root
+u32 TREE_ROOT_ARR[FACE_COUNT] =
+  { 0 }; // tree root advertised by the neighbor on each face
+u32 TREE_HOPS_ARR[FACE_COUNT] =
+  { 0 }; // hops to the root advertised by the neighbor on each face
+bool TREE_CHILD_ARR[FACE_COUNT] =
+  { false }; // whether the neighbor on each face has the host as its parent
+u32 TREE_TS_ARR[FACE_COUNT] =
+  { 0 }; // host time-stamp of the last (n)eighbor packet on each face
+u32 BUCKET_FACE_ARR[FACE_COUNT] =
+  { 0 }; // rate limit tokens (1/1000ths) left for each face
+u32 BUCKET_TS_FACE_ARR[FACE_COUNT] =
+  { 0 }; // host time-stamp of the last refill of each face's bucket
+u32 FWD_FACE_ARR[FACE_COUNT] =
+  { 0 }; // count of packets forwarded out of each face
+u32 SUP_FACE_ARR[FACE_COUNT] =
+  { 0 }; // count of duplicate/stale packets suppressed, by receiving face
+u32 FACE_CAPS_ARR[FACE_COUNT] =
+  { 0 }; // capability flags last advertised by neighboring nodes
 
 /*
  * Summary:     Distinguishing keys for IXM node and packet
@@ -80,11 +385,39 @@ struct KEY
 
 /*
  * Summary:     (c)alculation packet structure
- * Contains:    u32 calculation
+ * Contains:    u32 calculation argument, u32 workload (WORK_*)
  */
 struct C_PKT
 {
   u32 calc;
+  u32 work;
+};
+
+/*
+ * Summary:     (p)art packet structure; votes on one part of a (p)artitioned
+ *              calculation
+ * Contains:    u32 voter ID, u32 calculation version, u32 part, u32 count of
+ *              primes within the part
+ */
+struct P_PKT
+{
+  u32 ID;
+  u32 calc_ver;
+  u32 part;
+  u32 count;
+};
+
+/*
+ * Summary:     (n)eighbor packet structure; only ever sent one hop
+ * Contains:    u32 sender ID, u32 tree root ID, u32 hops to the root, u32 ID
+ *              of the sender's parent (its own ID if it has none)
+ */
+struct N_PKT
+{
+  u32 ID;
+  u32 root;
+  u32 hops;
+  u32 parent;
 };
 
 /*
@@ -98,7 +431,95 @@ struct R_PKT
   u32 calc; // denotes the n_th prime calculation
   u32 calc_ver; // denotes the calculation version
   u32 rslt; // denotes the n_th prime result
-  u32 neighbor; // flag sent from neighboring nodes
+  u32 neighbor; // flags sent from neighboring nodes (NEIGHBOR_FLAG, WIRE_*)
 };
 
+R_PKT BATCH_ARR[FACE_COUNT][BATCH_MAX]; // records queued on each face
+u32 BATCH_COUNT_ARR[FACE_COUNT] =
+  { 0 }; // count of records queued on each face
+
+#if PRIME_TABLE
+/*
+ * Summary:     Compile-time prime generation for the flash-resident lookup
+ *              table.  Primality is settled by trial division with the primes
+ *              already generated, so every table entry only instantiates the
+ *              handful of templates needed to step over to the next prime.
+ *              The instantiation cost climbs steeply with the table size, so
+ *              the table stops at PRIME_TABLE_SIZE and the sieve covers the
+ *              rest of the range.
+ * Contains:    TableNthPrime<N>::value, the N_th prime.
+ */
+template<u32 N>
+  struct TableNthPrime;
+
+template<>
+  struct TableNthPrime<1>
+  {
+    static const u32 value = 2;
+  };
+
+template<>
+  struct TableNthPrime<2>
+  {
+    static const u32 value = 3;
+  };
+
+// X is prime unless divisible by the K_th prime D or a later one up to its root
+template<u32 X, u32 K, u32 D = TableNthPrime<K>::value, bool STOP = ((D * D
+    > X) || (0 == X % D))>
+  struct TableIsPrime
+  {
+    static const bool value = TableIsPrime<X, K + 1>::value;
+  };
+
+template<u32 X, u32 K, u32 D>
+  struct TableIsPrime<X, K, D, true>
+  {
+    static const bool value = (D * D > X);
+  };
+
+// smallest prime at or above the odd integer X
+template<u32 X, bool PRIME = TableIsPrime<X, 2>::value>
+  struct TableNextPrime
+  {
+    static const u32 value = TableNextPrime<X + 2>::value;
+  };
+
+template<u32 X>
+  struct TableNextPrime<X, true>
+  {
+    static const u32 value = X;
+  };
+
+template<u32 N>
+  struct TableNthPrime
+  {
+    static const u32 value =
+        TableNextPrime<TableNthPrime<N - 1>::value + 2>::value;
+  };
+
+// Entries are listed in order so each one builds on the one before it
+#define PRIME_TABLE_1(n) TableNthPrime<(n)>::value
+#define PRIME_TABLE_10(n) PRIME_TABLE_1(n), PRIME_TABLE_1(n + 1), \
+  PRIME_TABLE_1(n + 2), PRIME_TABLE_1(n + 3), PRIME_TABLE_1(n + 4), \
+  PRIME_TABLE_1(n + 5), PRIME_TABLE_1(n + 6), PRIME_TABLE_1(n + 7), \
+  PRIME_TABLE_1(n + 8), PRIME_TABLE_1(n + 9)
+#define PRIME_TABLE_100(n) PRIME_TABLE_10(n), PRIME_TABLE_10(n + 10), \
+  PRIME_TABLE_10(n + 20), PRIME_TABLE_10(n + 30), PRIME_TABLE_10(n + 40), \
+  PRIME_TABLE_10(n + 50), PRIME_TABLE_10(n + 60), PRIME_TABLE_10(n + 70), \
+  PRIME_TABLE_10(n + 80), PRIME_TABLE_10(n + 90)
+#define PRIME_TABLE_1000(n) PRIME_TABLE_100(n), PRIME_TABLE_100(n + 100), \
+  PRIME_TABLE_100(n + 200), PRIME_TABLE_100(n + 300), \
+  PRIME_TABLE_100(n + 400), PRIME_TABLE_100(n + 500), \
+  PRIME_TABLE_100(n + 600), PRIME_TABLE_100(n + 700), \
+  PRIME_TABLE_100(n + 800), PRIME_TABLE_100(n + 900)
+
+const u16 PRIME_TABLE_ARR[PRIME_TABLE_SIZE] =
+  { PRIME_TABLE_1000(1) }; // first PRIME_TABLE_SIZE primes, kept in flash
+
+// Refuse to build if the table doesn't line up with the known 1000th prime
+typedef char PRIME_TABLE_CHECK[(7919 == TableNthPrime<PRIME_TABLE_SIZE>::value)
+    ? 1 : -1];
+#endif
+
 #endif
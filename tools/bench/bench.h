@@ -0,0 +1,62 @@
+/*
+ * Title:  bench
+ *
+ * Description:  Helpers the benchmarks share:  a host clock and a driver
+ * that runs a workload step to completion the way calcSlice does, timing
+ * each step.  Include it after the sketch.
+ */
+
+#ifndef BENCH_H_GUARD
+#define BENCH_H_GUARD
+
+#include <time.h>
+
+/* host time in ns */
+u64
+benchNs()
+{
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+
+  return (u64) t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/* what a job cost:  steps taken, host time in all and in the longest step */
+struct BenchJob
+{
+  u32 rslt;
+  u32 steps;
+  u64 ns;
+  u64 worstNs;
+};
+
+/* runs a workload step on a fresh job until it's done */
+BenchJob
+benchRun(bool (*step)(u32, u32 *), u32 arg)
+{
+  BenchJob job;
+
+  job.steps = 0;
+  job.ns = 0;
+  job.worstNs = 0;
+  JOB_POS = 0;
+  JOB_ACC = 0;
+  JOB_PART = INVALID;
+  LEHMER_PHASE = 0;
+
+  for (bool done = false; !done;)
+    {
+      u64 start = benchNs();
+      done = step(arg, &job.rslt);
+      u64 ns = benchNs() - start;
+
+      ++job.steps;
+      job.ns += ns;
+      job.worstNs = (ns > job.worstNs) ? ns : job.worstNs;
+    }
+
+  return job;
+}
+
+#endif
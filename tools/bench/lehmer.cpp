@@ -0,0 +1,84 @@
+/*
+ * Title:  lehmer
+ *
+ * Description:  Host time and peak memory of the Meissel-Lehmer count
+ * (lehmerStep), for the primes up to x (piStep) and for the n_th prime past
+ * the segmented range (primeStep), driven a step at a time as calcSlice
+ * does.  The requests go up to the n = 10^9 asked for only as far as the
+ * sketch can:  results, ballots and (r)esult packets are all 32 bits, so n
+ * stops at PRIME_LEHMER_THRESHOLD (p_n = 4294967291) and x at 2^32 - 1.
+ *
+ * Peak memory is the process's resident high-water mark (getrusage), in
+ * KiB, so with the requests in ascending order each row shows what the
+ * count has needed so far; the first row is the sketch with nothing
+ * counted yet.  Its tables are all static, so the column should stay flat.  The prime count checkpoints are forgotten before each run
+ * so every count starts from scratch.
+ *
+ * Usage:  lehmer
+ */
+
+#include "../../suffrage.cpp"
+#include "bench.h"
+#include <sys/resource.h>
+
+/* the resident high-water mark in KiB */
+long
+peakKiB()
+{
+  struct rusage r;
+
+  getrusage(RUSAGE_SELF, &r);
+
+  return r.ru_maxrss;
+}
+
+/* forgets the prime count checkpoints and the segments located */
+void
+forget()
+{
+  SEGMENT_LOW = 0;
+  SEGMENT_COUNT = 0;
+  PI_INDEX_TOP = 1;
+
+  for (u32 k = 1; k < PI_INDEX_SIZE; ++k)
+    PI_INDEX_ARR[k] = 0;
+
+  return;
+}
+
+/* runs and prints one request */
+void
+row(const char * name, bool (*step)(u32, u32 *), u32 arg)
+{
+  forget();
+  BenchJob job = benchRun(step, arg);
+
+  printf("%-6s %10u %10u %12.0f %6u %10.0f %8ld\n", name, arg, job.rslt,
+      (double) job.ns, job.steps, (double) job.worstNs, peakKiB());
+
+  return;
+}
+
+int
+main()
+{
+  u32 xs[] =
+    { 10000000, 100000000, 1000000000, 0xffffffff };
+  u32 ns[] =
+    { 10000000, 100000000, PRIME_LEHMER_THRESHOLD };
+
+  setup();
+
+  printf("%-6s %10s %10s %12s %6s %10s %8s\n", "count", "arg", "result",
+      "ns", "steps", "worst_ns", "peak_KiB");
+  printf("%-6s %10s %10s %12s %6s %10s %8ld\n", "-", "-", "-", "-", "-", "-",
+      peakKiB());
+
+  for (u32 i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i)
+    row("pi", piStep, xs[i]);
+
+  for (u32 i = 0; i < sizeof(ns) / sizeof(ns[0]); ++i)
+    row("p_n", primeStep, ns[i]);
+
+  return 0;
+}
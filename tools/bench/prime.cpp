@@ -0,0 +1,146 @@
+/*
+ * Title:  prime
+ *
+ * Description:  The n_th prime before and after the retained incremental
+ * sieve.  The old calculate() sieved the whole array again for every
+ * request (it's copied here from before the change, loop variable mix-up
+ * and all);  the new path extends the retained sieve only past what it
+ * covers and walks a cursor to the prime.  Both are timed for every n up to
+ * the old PRIME_THRESHOLD, and the new one on up to the current
+ * PRIME_THRESHOLD, ascending and in random order, from an empty sieve.
+ *
+ * Usage:  prime
+ */
+
+#include "../../suffrage.cpp"
+#include "bench.h"
+#include <algorithm>
+#include <vector>
+
+const u32 OLD_PRIME_THRESHOLD = 1000; // Accept nothing higher than the 1000th prime
+const u32 OLD_PRIME_ARR_THRESHOLD = 7920; // 1000th prime is 7919
+
+char oldSieve[OLD_PRIME_ARR_THRESHOLD];
+
+/* calculate() as it was, FAULTY and status LED left out */
+u32
+oldCalculate(u32 b)
+{
+  u32 c;
+  u32 i;
+  u32 j;
+  u32 k;
+
+  // three embedded FOR-loops = efficiency hell
+  for (i = 3; i < OLD_PRIME_ARR_THRESHOLD; ++i)
+    {
+      c = 0;
+
+      for (i = 0; i < OLD_PRIME_ARR_THRESHOLD; ++i)
+        oldSieve[i] = 0;
+
+      for (j = 2; j * j <= i; j++)
+        if (!oldSieve[j])
+          for (k = j + j; k < i; k += j)
+            oldSieve[k] = 1;
+
+      for (j = 2; j < i; j++)
+        {
+          if (!oldSieve[j])
+            ++c;
+          if (b == c)
+            return j;
+        }
+    }
+
+  return 0;
+}
+
+/* forgets the retained sieve and its cursor */
+void
+sieveForget()
+{
+  memset(sieve, 0, sizeof(sieve));
+  SIEVE_LIMIT = 0;
+  PRIME_CURSOR_W = 0;
+  PRIME_CURSOR_N = 0;
+
+  return;
+}
+
+/* times the new path over the n in order, from an empty sieve */
+void
+sweep(const char * name, const std::vector<u32> & order, const u32 * want)
+{
+  u64 ns = 0, worst = 0;
+  u32 steps = 0, wrong = 0;
+
+  sieveForget();
+
+  for (u32 i = 0; i < order.size(); ++i)
+    {
+      BenchJob job = benchRun(sieveStep, order[i]);
+
+      ns += job.ns;
+      steps += job.steps;
+      worst = (job.ns > worst) ? job.ns : worst;
+      wrong += (want && (order[i] <= OLD_PRIME_THRESHOLD) && (job.rslt
+          != want[order[i]])) ? 1 : 0;
+    }
+
+  printf("%-28s %6u %12.0f %10.0f %8u %6u\n", name, (u32) order.size(),
+      (double) ns / order.size(), (double) worst, steps, wrong);
+
+  return;
+}
+
+int
+main()
+{
+  setup();
+
+  static u32 want[OLD_PRIME_THRESHOLD + 1];
+  u64 ns = 0, worst = 0;
+
+  for (u32 n = 1; n <= OLD_PRIME_THRESHOLD; ++n)
+    {
+      u64 start = benchNs();
+      want[n] = oldCalculate(n);
+      u64 took = benchNs() - start;
+
+      ns += took;
+      worst = (took > worst) ? took : worst;
+    }
+
+  printf("%-28s %6s %12s %10s %8s %6s\n", "path", "calcs", "ns/calc",
+      "worst_ns", "steps", "wrong");
+  printf("%-28s %6u %12.0f %10.0f %8s %6s\n", "old, n = 1..1000",
+      OLD_PRIME_THRESHOLD, (double) ns / OLD_PRIME_THRESHOLD, (double) worst,
+      "-", "-");
+
+  std::vector<u32> order;
+
+  for (u32 n = 1; n <= OLD_PRIME_THRESHOLD; ++n)
+    order.push_back(n);
+
+  sweep("new, n = 1..1000", order, want);
+
+  for (u32 n = OLD_PRIME_THRESHOLD + 1; n <= PRIME_THRESHOLD; ++n)
+    order.push_back(n);
+
+  sweep("new, n = 1..PRIME_THRESHOLD", order, want);
+
+  u32 seed = 1;
+
+  for (u32 i = order.size() - 1; i > 0; --i)
+    { // shuffle them
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      std::swap(order[i], order[seed % (i + 1)]);
+    }
+
+  sweep("new, random order", order, want);
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * Title:  segment
+ *
+ * Description:  Segment size against time-to-vote for the n_th primes past
+ * the retained sieve.  Each request is run as a fresh job from an empty
+ * segment state and checkpoint index, a step at a time as calcSlice runs
+ * it.  A board spends a calcSlice_PERIOD after every CALC_SLICE steps, so
+ * the slices give its time-to-vote in ms, on top of the computing itself.
+ * The segment size is SEGMENT_WORDS as built;  make bench builds this once
+ * per size in SEGMENT_SIZES.
+ *
+ * Usage:  segment [-H]   (-H prints the header first)
+ */
+
+#include "../../suffrage.cpp"
+#include "bench.h"
+
+/* forgets the segments located and the prime count checkpoints */
+void
+segmentForget()
+{
+  SEGMENT_LOW = 0;
+  SEGMENT_COUNT = 0;
+  PI_INDEX_TOP = 1;
+
+  for (u32 k = 1; k < PI_INDEX_SIZE; ++k)
+    PI_INDEX_ARR[k] = 0;
+
+  return;
+}
+
+int
+main(int argc, char ** argv)
+{
+  u32 requests[] =
+    { 20000, 100000, 300000, PRIME_SEGMENTED_THRESHOLD };
+
+  setup();
+
+  if ((argc > 1) && (0 == strcmp(argv[1], "-H")))
+    printf("%5s %6s %8s %10s %7s %7s %9s %9s\n", "words", "bytes", "n",
+        "prime", "steps", "slices", "host_ms", "worst_us");
+
+  for (u32 i = 0; i < sizeof(requests) / sizeof(requests[0]); ++i)
+    {
+      segmentForget();
+      BenchJob job = benchRun(primeStep, requests[i]);
+      u32 slices = (job.steps + CALC_SLICE - 1) / CALC_SLICE;
+
+      printf("%5u %6u %8u %10u %7u %7u %9.2f %9.1f\n", SEGMENT_WORDS,
+          SEGMENT_WORDS * 4, requests[i], job.rslt, job.steps, slices
+              * calcSlice_PERIOD, job.ns / 1e6, job.worstNs / 1e3);
+    }
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*
+ * Title:  sieve
+ *
+ * Description:  The retained sieve as one byte per integer (before) and as
+ * one bit per odd integer (now):  the memory each takes to cover the old
+ * and the new PRIME_ARR_THRESHOLD, how long it takes to sieve that far from
+ * scratch and how long locating each of the primes in it takes, ascending.
+ * The byte layout is copied from before the change, sized up to cover the
+ * same range.
+ *
+ * Usage:  sieve
+ */
+
+#include "../../suffrage.cpp"
+#include "bench.h"
+
+const u32 OLD_PRIME_ARR_THRESHOLD = 7920; // 1000th prime is 7919
+const u32 ROUNDS = 20; // times each measurement is taken, the best one counts
+
+char byteSieve[PRIME_ARR_THRESHOLD];
+u32 BYTE_LIMIT = 0; // every integer below this has been sieved
+u32 BYTE_CURSOR_N = 0; // sequence of the last prime located in the sieve
+u32 BYTE_CURSOR_P = 0; // value of the last prime located in the sieve
+
+/* sieveExtend as it was, on the byte layout */
+void
+byteExtend(u32 limit)
+{
+  if (limit > PRIME_ARR_THRESHOLD) // never reach past the sieve array
+    limit = PRIME_ARR_THRESHOLD;
+
+  if (limit <= BYTE_LIMIT) // already sieved
+    return;
+
+  u32 low = BYTE_LIMIT; // beginning of the new range
+
+  for (u32 i = low; i < limit; ++i)
+    byteSieve[i] = (i < 2) ? 1 : 0; // 0 and 1 aren't prime, assume the rest are
+
+  for (u32 p = 2; p * p < limit; ++p)
+    {
+      if (byteSieve[p])
+        continue;
+
+      u32 k = p * p; // smaller multiples were crossed off by smaller primes
+
+      if (k < low) // start from the first multiple within the new range
+        k = ((low + p - 1) / p) * p;
+
+      for (; k < limit; k += p)
+        byteSieve[k] = 1;
+    }
+
+  BYTE_LIMIT = limit;
+
+  return;
+}
+
+/* nthPrime as it was, on the byte layout */
+u32
+byteNthPrime(u32 n)
+{
+  if (n < 1) // there is no 0_th prime
+    return 0;
+
+  byteExtend(primeBound(n)); // only sieves what hasn't been sieved yet
+
+  if (0 == BYTE_CURSOR_N) // the cursor starts at the first prime
+    {
+      BYTE_CURSOR_N = 1;
+      BYTE_CURSOR_P = 2;
+    }
+
+  while (BYTE_CURSOR_N > n)
+    { // walk back to the previous prime
+      do
+        --BYTE_CURSOR_P;
+      while (byteSieve[BYTE_CURSOR_P]);
+
+      --BYTE_CURSOR_N;
+    }
+
+  while (BYTE_CURSOR_N < n)
+    { // walk forward to the next prime
+      u32 p = BYTE_CURSOR_P;
+
+      do
+        ++p;
+      while ((p < BYTE_LIMIT) && byteSieve[p]);
+
+      if (p >= BYTE_LIMIT) // ran off the end of the sieve
+        return 0;
+
+      BYTE_CURSOR_P = p;
+      ++BYTE_CURSOR_N;
+    }
+
+  return BYTE_CURSOR_P;
+}
+
+/* forgets both sieves and their cursors */
+void
+forget()
+{
+  memset(byteSieve, 0, sizeof(byteSieve));
+  BYTE_LIMIT = 0;
+  BYTE_CURSOR_N = 0;
+  BYTE_CURSOR_P = 0;
+  memset(sieve, 0, sizeof(sieve));
+  SIEVE_LIMIT = 0;
+  PRIME_CURSOR_W = 0;
+  PRIME_CURSOR_N = 0;
+
+  return;
+}
+
+/* best time of ROUNDS to sieve up to limit from scratch, in ns */
+u64
+timeExtend(void (*extend)(u32), u32 limit)
+{
+  u64 best = ~(u64) 0;
+
+  for (u32 r = 0; r < ROUNDS; ++r)
+    {
+      forget();
+      u64 start = benchNs();
+      extend(limit);
+      u64 ns = benchNs() - start;
+      best = (ns < best) ? ns : best;
+    }
+
+  return best;
+}
+
+/* best time of ROUNDS to locate the primes 1..count in order, in ns */
+u64
+timeLocate(u32 (*locate)(u32), u32 count, u32 * check)
+{
+  u64 best = ~(u64) 0;
+
+  for (u32 r = 0; r < ROUNDS; ++r)
+    {
+      forget();
+      locate(count); // sieve first, only the walk is timed
+      *check = 0;
+      u64 start = benchNs();
+
+      for (u32 n = 1; n <= count; ++n)
+        *check += locate(n);
+
+      u64 ns = benchNs() - start;
+      best = (ns < best) ? ns : best;
+    }
+
+  return best;
+}
+
+int
+main()
+{
+  setup();
+
+  u32 covers[] =
+    { OLD_PRIME_ARR_THRESHOLD, PRIME_ARR_THRESHOLD };
+  u32 counts[] =
+    { 1000, PRIME_THRESHOLD };
+
+  printf("%-6s %8s %8s %10s %10s %12s\n", "layout", "range", "bytes",
+      "sieve_us", "ns/int", "locate_ns/n");
+
+  for (u32 i = 0; i < 2; ++i)
+    {
+      u32 byteSum, bitSum;
+      u64 byteSieveNs = timeExtend(byteExtend, covers[i]);
+      u64 bitSieveNs = timeExtend(sieveExtend, covers[i]);
+      u64 byteLocateNs = timeLocate(byteNthPrime, counts[i], &byteSum);
+      u64 bitLocateNs = timeLocate(nthPrime, counts[i], &bitSum);
+
+      printf("%-6s %8u %8u %10.1f %10.2f %12.1f\n", "byte", covers[i],
+          covers[i], byteSieveNs / 1000.0, (double) byteSieveNs / covers[i],
+          (double) byteLocateNs / counts[i]);
+      printf("%-6s %8u %8u %10.1f %10.2f %12.1f%s\n", "bit", covers[i],
+          ((covers[i] / 2 + 31) / 32) * 4, bitSieveNs / 1000.0,
+          (double) bitSieveNs / covers[i], (double) bitLocateNs / counts[i],
+          (byteSum == bitSum) ? "" : "  (primes differ!)");
+    }
+
+  return 0;
+}
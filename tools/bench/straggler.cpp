@@ -0,0 +1,161 @@
+/*
+ * Title:  straggler
+ *
+ * Description:  Cost of a straggler's vote in a ballot box of 1024 nodes:
+ * the box takes over the live tally of the first 960 votes as its version
+ * is superseded, and the last 64 come in late.  They're counted through
+ * boxVote (the box's own candidate table and incremental tally) and
+ * through the pairwise recount of every ballot it replaced, copied here
+ * from before the change.  The ballots are all different or spread over
+ * fewer candidates; the majority both report is compared after every vote.
+ *
+ * Usage:  straggler
+ */
+
+#define NODE_CAPACITY 1024
+#include "../../suffrage.cpp"
+#include "bench.h"
+#include "sim.h"
+
+const u32 LATE = 64; // votes that come in after the box opened
+const u32 ROUNDS = 5; // boxes per setup, the best one counts
+
+/* boxTally's recount as it was:  the box's majority from its ballots */
+u32
+oldRecount(u32 b)
+{
+  u32 votes = 0, top = 0, next = 0, lead = 0;
+
+  for (u32 i = 0; i < NODE_COUNT; ++i)
+    {
+      u32 same = 0;
+
+      if (0 == BOX_VOTE_ARR[b][i])
+        continue;
+
+      ++votes;
+
+      for (u32 j = 0; j < NODE_COUNT; ++j)
+        if (BOX_VOTE_ARR[b][j] == BOX_VOTE_ARR[b][i])
+          {
+            if (j < i)
+              break; // counted the candidate already
+
+            ++same;
+          }
+
+      if (same > top)
+        {
+          next = top;
+          top = same;
+          lead = BOX_VOTE_ARR[b][i];
+        }
+
+      else if (same > next)
+        next = same;
+    }
+
+  if (votes < VOTE_COUNT_MIN)
+    return 0;
+
+  return (next == top) ? TIE : lead;
+}
+
+/* a box holding the first votes of a new version; returns its index */
+u32
+boxUp(const u32 * ballots)
+{
+  flush();
+  ++HOST_CALC_VER;
+  JOIN_TS = millis(); // still discovering, so nothing turns final
+
+  for (u32 i = 0; i < NODE_CAPACITY - LATE; ++i)
+    voteCount(i, ballots[i]);
+
+  boxOpen();
+
+  return boxFind(HOST_CALC_VER);
+}
+
+int
+main()
+{
+  Board board;
+  u32 spreads[] =
+    { NODE_CAPACITY, 64, 2 };
+  u32 seed = 1;
+
+  boardInit(&board, 1);
+  simBoard = &board;
+  setup();
+  boardEnter(&board, 2000);
+  HOST_CALC = 1000;
+
+  for (u32 id = 2000; NODE_COUNT < NODE_CAPACITY; id += 7)
+    log(id, millis()); // every node known
+
+  printf("%6s %10s %10s %10s\n", "nodes", "candidates", "old_ns", "new_ns");
+
+  for (u32 s = 0; s < sizeof(spreads) / sizeof(spreads[0]); ++s)
+    {
+      u32 ballots[NODE_CAPACITY];
+      u64 oldNs = ~(u64) 0, newNs = ~(u64) 0;
+      u32 mismatches = 0;
+
+      for (u32 i = 0; i < NODE_CAPACITY; ++i)
+        {
+          seed ^= seed << 13;
+          seed ^= seed >> 17;
+          seed ^= seed << 5;
+          ballots[i] = 7919 + ((i < spreads[s]) ? i : seed % spreads[s]);
+        }
+
+      for (u32 r = 0; r < ROUNDS; ++r)
+        {
+          u32 oldMajority[LATE];
+          u32 b = boxUp(ballots);
+          u64 start = benchNs();
+
+          for (u32 i = 0; i < LATE; ++i)
+            {
+              BOX_VOTE_ARR[b][NODE_CAPACITY - LATE + i] = ballots[NODE_CAPACITY
+                  - LATE + i];
+              oldMajority[i] = oldRecount(b);
+            }
+
+          u64 ns = benchNs() - start;
+          oldNs = (ns < oldNs) ? ns : oldNs;
+          boxClose(b);
+
+          b = boxUp(ballots);
+          start = benchNs();
+
+          for (u32 i = 0; i < LATE; ++i)
+            boxVote(b, NODE_CAPACITY - LATE + i, ballots[NODE_CAPACITY - LATE
+                + i]);
+
+          ns = benchNs() - start;
+          newNs = (ns < newNs) ? ns : newNs;
+          boxClose(b);
+
+          b = boxUp(ballots); // once more, checking the majority every vote
+
+          for (u32 i = 0; i < LATE; ++i)
+            {
+              boxVote(b, NODE_CAPACITY - LATE + i, ballots[NODE_CAPACITY
+                  - LATE + i]);
+
+              if (BOX_MAJORITY_ARR[b] != oldMajority[i])
+                ++mismatches;
+            }
+
+          boxClose(b);
+        }
+
+      printf("%6u %10u %10.0f %10.0f%s\n", NODE_CAPACITY, spreads[s],
+          (double) oldNs / LATE, (double) newNs / LATE,
+          mismatches ? "  (majorities differ!)" : "");
+    }
+
+  return 0;
+}
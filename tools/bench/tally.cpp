@@ -0,0 +1,162 @@
+/*
+ * Title:  tally
+ *
+ * Description:  Cost of a vote with many discordant candidates:  1024
+ * nodes vote, all for different results or spread over fewer candidates,
+ * through voteCount (candidate hash index and incremental tally) and
+ * through the linear search and full rescan it replaced, copied here from
+ * before the change.  The old column times only that candidate part of
+ * the old voteCount, the new one the whole of voteCount.  The majority
+ * both report is compared after every vote.
+ *
+ * Usage:  tally
+ */
+
+#define NODE_CAPACITY 1024
+#include "../../suffrage.cpp"
+#include "bench.h"
+
+const u32 ROUNDS = 20; // elections per setup, the best one counts
+
+u32 OLD_CANDIDATE_ARR[NODE_CAPACITY + 1]; // candidates as they were kept, and
+u32 OLD_VOTES_ARR[NODE_CAPACITY + 1]; // their votes (scanned one past the last)
+u32 OLD_COUNT = 0;
+
+/* linearSearch as it was, checks left out */
+u32
+linearSearch(u32 a[], u32 size, u32 key)
+{
+  for (u32 i = 0; i < size; ++i)
+    if (a[i] == key) // If there is a match
+      return i; // say so
+
+  return INVALID; // Otherwise, return the signal that there is no match
+}
+
+/* getMaxIndex as it was, checks left out */
+u32
+getMaxIndex(u32 a[], u32 size)
+{
+  bool tiedetected = false; // flag to mark if there is a tie
+  u32 maxVotes = 0; // highest amount of ballots currently
+  u32 maxIndex = INVALID; // index of the highest candidate
+
+  for (u32 i = 0; i < size; ++i)
+    { // iterate through the entire array
+      if (a[i] > maxVotes)
+        { // record higher values
+          maxVotes = a[i];
+          maxIndex = i;
+          tiedetected = false; // disarm tie flag
+        }
+      // if there is ever candidate that ties with the highest candidate
+      else if (a[i] == maxVotes)
+        tiedetected = true; // set tie flag
+    }
+
+  if (tiedetected) // if the tie flag was set
+    return TIE; // there is no winning candidate
+
+  return maxIndex;
+}
+
+/* the candidate part of voteCount and evalMajority as they were */
+u32
+oldVote(u32 BALLOT)
+{
+  // look to see if the ballot is for an existing candidate
+  u32 k = linearSearch(OLD_CANDIDATE_ARR, OLD_COUNT + 1, BALLOT);
+
+  if (INVALID != k) // if so, give him a vote
+    ++OLD_VOTES_ARR[k];
+
+  else // otherwise the ballot is new to the candidate list
+    { // so add it
+      k = OLD_COUNT++; // Give him a vote
+      OLD_CANDIDATE_ARR[k] = BALLOT; // Add the new candidate to the nominations list
+      ++OLD_VOTES_ARR[k]; // Give the candidate a vote
+    }
+
+  u32 j = getMaxIndex(OLD_VOTES_ARR, (OLD_COUNT + 1));
+
+  return (TIE == j) ? TIE : OLD_CANDIDATE_ARR[j];
+}
+
+/* a fresh election on NODE_CAPACITY nodes */
+void
+elect()
+{
+  flush();
+  NODE_COUNT = NODE_CAPACITY;
+  HOST_CALC = 1000;
+  OLD_COUNT = 0;
+  memset(OLD_CANDIDATE_ARR, 0, sizeof(OLD_CANDIDATE_ARR));
+  memset(OLD_VOTES_ARR, 0, sizeof(OLD_VOTES_ARR));
+
+  return;
+}
+
+int
+main()
+{
+  u32 spreads[] =
+    { NODE_CAPACITY, 256, 16, 2 };
+  u32 seed = 1;
+
+  setup();
+  printf("%6s %10s %10s %10s\n", "nodes", "candidates", "old_ns", "new_ns");
+
+  for (u32 s = 0; s < sizeof(spreads) / sizeof(spreads[0]); ++s)
+    {
+      u32 ballots[NODE_CAPACITY];
+      u64 oldNs = ~(u64) 0, newNs = ~(u64) 0;
+      u32 mismatches = 0;
+
+      for (u32 i = 0; i < NODE_CAPACITY; ++i)
+        { // every candidate gets at least one vote
+          seed ^= seed << 13;
+          seed ^= seed >> 17;
+          seed ^= seed << 5;
+          ballots[i] = 7919 + ((i < spreads[s]) ? i : seed % spreads[s]);
+        }
+
+      for (u32 r = 0; r < ROUNDS; ++r)
+        {
+          u32 oldMajority[NODE_CAPACITY];
+
+          elect();
+          u64 start = benchNs();
+
+          for (u32 i = 0; i < NODE_CAPACITY; ++i)
+            oldMajority[i] = oldVote(ballots[i]);
+
+          u64 ns = benchNs() - start;
+          oldNs = (ns < oldNs) ? ns : oldNs;
+
+          elect();
+          start = benchNs();
+
+          for (u32 i = 0; i < NODE_CAPACITY; ++i)
+            voteCount(i, ballots[i]);
+
+          ns = benchNs() - start;
+          newNs = (ns < newNs) ? ns : newNs;
+
+          elect(); // once more, checking the majority after every vote
+
+          for (u32 i = 0; i < NODE_CAPACITY; ++i)
+            {
+              voteCount(i, ballots[i]);
+
+              if ((i > 0) && (MAJORITY_RSLT != oldMajority[i]))
+                ++mismatches;
+            }
+        }
+
+      printf("%6u %10u %10.3f %10.3f%s\n", NODE_CAPACITY, spreads[s],
+          (double) oldNs / NODE_CAPACITY, (double) newNs / NODE_CAPACITY,
+          mismatches ? "  (majorities differ!)" : "");
+    }
+
+  return 0;
+}
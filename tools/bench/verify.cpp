@@ -0,0 +1,94 @@
+/*
+ * Title:  verify
+ *
+ * Description:  Time to the host's vote on the n_th prime with and without
+ * VERIFY_MODE.  Without it the board locates the prime (primeStep, the
+ * plain path); with it the leading candidate is checked first (verifyStep)
+ * and the prime is only located when the check fails, so a wrong candidate
+ * costs both.  The wrong one is the (n - 1)_th prime, which passes the trial
+ * division and is only caught by the count.  Each is driven to completion a
+ * step at a time, as calcSlice does, across n from the retained sieve
+ * through the segments to the Meissel-Lehmer count; the base primes are
+ * sieved beforehand, as on a board that's been voting for a while, but the
+ * sieve's cursor and the prime count checkpoints are forgotten before each
+ * run, so none of them gains from another's.
+ *
+ * Usage:  verify
+ */
+
+#include "../../suffrage.cpp"
+#include "bench.h"
+
+u32 CANDIDATE = 0; // what verifyRun checks
+
+/* verifyStep on CANDIDATE in benchRun's shape:  1 if it's the n_th prime */
+bool
+verifyRun(u32 n, u32 * rslt)
+{
+  bool ok;
+  bool done = verifyStep(n, CANDIDATE, &ok);
+
+  *rslt = ok ? 1 : 0;
+
+  return done;
+}
+
+/* forgets the primes located and counted, but not the sieve itself */
+void
+forget()
+{
+  PRIME_CURSOR_W = 0;
+  PRIME_CURSOR_N = 0;
+  SEGMENT_LOW = 0;
+  SEGMENT_COUNT = 0;
+  PI_INDEX_TOP = 1;
+
+  for (u32 k = 1; k < PI_INDEX_SIZE; ++k)
+    PI_INDEX_ARR[k] = 0;
+
+  return;
+}
+
+int
+main()
+{
+  u32 ns[] =
+    { 1000, PRIME_THRESHOLD, 100000, PRIME_SEGMENTED_THRESHOLD, 10000000,
+        100000000, PRIME_LEHMER_THRESHOLD };
+  u32 wrong = 0;
+
+  setup();
+  sieveExtend(isqrt(0xffffffff) + 1);
+
+  printf("%10s %12s %8s %12s %8s %12s %8s\n", "n", "compute_ns", "steps",
+      "verify_ns", "steps", "wrong_ns", "steps");
+
+  for (u32 i = 0; i < sizeof(ns) / sizeof(ns[0]); ++i)
+    {
+      u32 p = benchRun(primeStep, ns[i]).rslt;
+      u32 q = benchRun(primeStep, ns[i] - 1).rslt;
+
+      forget();
+      BenchJob plain = benchRun(primeStep, ns[i]);
+
+      forget();
+      CANDIDATE = p;
+      BenchJob right = benchRun(verifyRun, ns[i]);
+
+      forget();
+      CANDIDATE = q;
+      BenchJob bad = benchRun(verifyRun, ns[i]); // then computed as above
+
+      wrong += ((p != plain.rslt) || (1 != right.rslt) || (0 != bad.rslt))
+          ? 1 : 0;
+
+      printf("%10u %12.0f %8u %12.0f %8u %12.0f %8u\n", ns[i],
+          (double) plain.ns, plain.steps, (double) right.ns, right.steps,
+          (double) (bad.ns + plain.ns), bad.steps + plain.steps);
+    }
+
+  if (wrong)
+    printf("%u verdicts wrong\n", wrong);
+
+  return wrong ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * Title:  wire
+ *
+ * Description:  Cost of the two (r)esult packet encodings:  the text 'r'
+ * packets and the (b)inary ones.  A mix of records is encoded with
+ * facePrintf and decoded with packetScanf, as sendR and the reflexes do,
+ * and the bytes on the wire are counted.  The printf and scanf underneath
+ * are the host stand-in's, so the times only compare the two encodings
+ * with each other.
+ *
+ * Usage:  wire
+ */
+
+#include "../../suffrage.cpp"
+#include "bench.h"
+#include "sim.h"
+#include <string>
+#include <vector>
+
+const u32 RECORDS = 4096; // records in the mix
+const u32 ROUNDS = 50; // times the mix is encoded and decoded
+
+u32 seedState = 1;
+
+u32
+random32()
+{
+  seedState ^= seedState << 13;
+  seedState ^= seedState >> 17;
+  seedState ^= seedState << 5;
+
+  return seedState;
+}
+
+/*
+ * Encodes and decodes the mix in one encoding.  Prints the mean bytes per
+ * line and the ns per record each way;  returns false if a record doesn't
+ * come back the same.
+ */
+bool
+measure(const char * name, const char * encode, const char * decode,
+    PrinterFn printer, ScannerFn scanner, const std::vector<R_PKT> & mix)
+{
+  Board * board = simBoard;
+  std::vector<std::string> lines(mix.size());
+  u64 encodeNs = ~(u64) 0, decodeNs = ~(u64) 0;
+  u64 bytes = 0;
+  bool same = true;
+
+  for (u32 r = 0; r < ROUNDS; ++r)
+    {
+      boardTake(board);
+      u64 start = benchNs();
+
+      for (u32 i = 0; i < mix.size(); ++i)
+        facePrintf(0, encode, printer, &mix[i]);
+
+      u64 ns = benchNs() - start;
+      encodeNs = (ns < encodeNs) ? ns : encodeNs;
+    }
+
+  for (u32 i = 0; i < mix.size(); ++i)
+    {
+      lines[i] = boardLine(board, i);
+      bytes += lines[i].size();
+    }
+
+  boardTake(board);
+
+  for (u32 r = 0; r < ROUNDS; ++r)
+    {
+      u64 start = benchNs();
+
+      for (u32 i = 0; i < mix.size(); ++i)
+        {
+          SimPacket packet;
+          R_PKT PKT_R;
+
+          packet.text = lines[i].data();
+          packet.length = lines[i].size();
+          packet.cursor = 0;
+          packet.source = 0;
+
+          if ((packetScanf((u8 *) &packet, decode, scanner, &PKT_R) != 3)
+              || (PKT_R.key.ID != mix[i].key.ID) || (PKT_R.key.TIME
+              != mix[i].key.TIME) || (PKT_R.rslt != mix[i].rslt))
+            same = false;
+        }
+
+      u64 ns = benchNs() - start;
+      decodeNs = (ns < decodeNs) ? ns : decodeNs;
+    }
+
+  printf("%-7s %10.1f %10.1f %10.1f   e.g. %s", name, (double) bytes
+      / mix.size(), (double) encodeNs / mix.size(), (double) decodeNs
+      / mix.size(), lines[0].c_str());
+
+  return same;
+}
+
+int
+main()
+{
+  Board board;
+
+  boardInit(&board, 1);
+  simBoard = &board;
+  setup();
+
+  // records as a grid of boards sends them:  four character IDs, a few
+  // hours of millis(), c1000..c1000000 on an early version
+  std::vector<R_PKT> mix(RECORDS);
+
+  for (u32 i = 0; i < RECORDS; ++i)
+    {
+      mix[i].key.ID = 46656 + random32() % (1679616 - 46656); // 1000..zzzz
+      mix[i].key.TIME = random32() % 10000000;
+      mix[i].calc = 1000 + random32() % 999001;
+      mix[i].calc_ver = 1 + random32() % 30;
+      mix[i].rslt = (random32() % 4) ? nthPrime(1 + mix[i].calc % 10000) : 0;
+      mix[i].neighbor = (random32() % 4) ? 0 : (NEIGHBOR_FLAG | WIRE_BINARY
+          | WIRE_LIVENESS | WIRE_BATCH);
+    }
+
+  printf("%-7s %10s %10s %10s\n", "wire", "bytes", "encode_ns", "decode_ns");
+
+  bool same = measure("text", "r%Z%z\n", "%Zr%z\n", R_ZPrinter, R_ZScanner,
+      mix);
+  same = measure("binary", "b%Z%z\n", "%Zb%z\n", R_BPrinter, R_BScanner, mix)
+      && same;
+
+  if (!same)
+    printf("records came back different!\n");
+
+  return same ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+ * Title:  work
+ *
+ * Description:  Throughput of the workloads in the registry (WORK_STEP_ARR)
+ * at a sample argument and at their limit (WORK_LIMIT_ARR), where the
+ * WORK_COST_ARR estimate is taken.  Each one runs as a fresh job from an
+ * empty sieve, no segments located and no prime count checkpoints, a step
+ * at a time as calcSlice runs it.  It reports the host time, ns per 1000
+ * units of argument next to the estimate, the steps and the longest one.  The (p)artitioned count runs on a lone board, which counts every
+ * part itself;  with nobody to second its votes none settle, so it's timed
+ * until it has voted on them all (JOB_IDLE) and its votes are summed.
+ *
+ * Usage:  work
+ */
+
+#include "../../suffrage.cpp"
+#include "bench.h"
+#include "sim.h"
+
+/* forgets the retained sieve, segments and prime count checkpoints */
+void
+workForget()
+{
+  memset(sieve, 0, sizeof(sieve));
+  SIEVE_LIMIT = 0;
+  PRIME_CURSOR_W = 0;
+  PRIME_CURSOR_N = 0;
+  SEGMENT_LOW = 0;
+  SEGMENT_COUNT = 0;
+  PI_INDEX_TOP = 1;
+
+  return;
+}
+
+/* runs the (p)artitioned count until the host has voted on every part */
+BenchJob
+partRun(u32 n)
+{
+  BenchJob job;
+
+  job.steps = 0;
+  job.ns = 0;
+  job.worstNs = 0;
+  JOB_POS = 0;
+  JOB_ACC = 0;
+  JOB_PART = INVALID;
+
+  for (JOB_IDLE = false; !JOB_IDLE;)
+    {
+      u64 start = benchNs();
+      partStep(n, &job.rslt);
+      u64 ns = benchNs() - start;
+
+      ++job.steps;
+      job.ns += ns;
+      job.worstNs = (ns > job.worstNs) ? ns : job.worstNs;
+    }
+
+  job.rslt = 0;
+
+  for (u32 j = 0; j < PART_COUNT; ++j)
+    {
+      u32 k = partSlot(j, ID_HOST);
+
+      job.rslt += (INVALID != k) ? PART_RSLT_ARR[j][k] - 1 : 0;
+    }
+
+  return job;
+}
+
+int
+main()
+{
+  u32 samples[WORK_COUNT] = // the arguments the estimates were first taken at
+    { 1000000, 100000000, 16000000, 16000000, 100000000 };
+  Board board; // partStep's clock and faces
+
+  boardInit(&board, 1);
+  simBoard = &board;
+  printf("%-6s %10s %12s %9s %10s %9s %7s %9s\n", "work", "arg", "rslt",
+      "host_ms", "ns/1000", "estimate", "steps", "worst_us");
+
+  for (u32 i = 0; i < 2 * WORK_COUNT; ++i)
+    {
+      u32 w = i / 2;
+      u32 arg = (i & 1) ? WORK_LIMIT_ARR[w] : samples[w];
+
+      if ((i & 1) && (arg == samples[w]))
+        continue; // the sample is the limit
+
+      workForget();
+      HOST_CALC = (w << WORK_SHIFT) | arg;
+      ++HOST_CALC_VER;
+      JOB_FAULTY = false;
+
+      BenchJob job;
+
+      if (WORK_PART == w)
+        {
+          partReset();
+          partRank();
+          job = partRun(arg);
+        }
+      else
+        job = benchRun(WORK_STEP_ARR[w], arg);
+
+      printf("%-6s %10u %12u %9.1f %10.1f %9u %7u %9.1f\n", WORK_NAME_ARR[w],
+          arg, job.rslt, job.ns / 1e6, (double) job.ns * 1000 / arg,
+          WORK_COST_ARR[w], job.steps, job.worstNs / 1e3);
+    }
+
+  return 0;
+}
@@ -0,0 +1,17 @@
+/*
+ * Title:  SFBErrors
+ *
+ * Description:  Blinkcodes of the API_ASSERT macros in sfb.h, numbered for
+ * the host only.
+ */
+
+#ifndef SFBERRORS_H_GUARD
+#define SFBERRORS_H_GUARD
+
+#define E_API_EQUAL 1
+#define E_API_NULL 2
+#define E_API_GREATER 3
+#define E_API_GREATER_EQUAL 4
+#define E_API_LESS 5
+
+#endif
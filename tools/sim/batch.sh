@@ -0,0 +1,37 @@
+#!/bin/sh
+# Batching on and off:  runs a single calculation on grids of 4, 16 and 32
+# boards with the sketch as built (board.so) and with BATCH_MODE=0, and
+# prints one CSV table, per build and size:  the boards that agreed,
+# packets sent and records forwarded in the TAIL ms after the command,
+# packets per simulated second, and the host ns the sketch's handlers took
+# per forwarded record (sim/grid.cpp's handler_ns over its forwarded, the
+# least of REPEAT runs, as the runs are deterministic but the host isn't).
+# The handlers' packet I/O is the stand-in's string handling, not the boards'
+# serial framing, so the ns compare the two builds rather than predict a
+# board's.
+#
+# usage:  batch.sh [grid binary] [batching board.so] [unbatched board.so]
+
+GRID=${1:-build/grid}
+BATCHED=${2:-build/board.so}
+UNBATCHED=${3:-build/unbatched.so}
+CMD=${CMD:-c5000}
+JITTER=${JITTER:-3}
+SEED=${SEED:-1}
+TAIL=${TAIL:-10000}
+REPEAT=${REPEAT:-3}
+
+echo "batching,boards,agreed,packets,forwarded,packets_per_s," \
+  "handler_ns,ns_per_forwarded" | tr -d ' '
+for so in "$BATCHED" "$UNBATCHED"; do
+  batching=on
+  [ "$so" = "$BATCHED" ] || batching=off
+  for size in "4 -w 2" "16 -w 4" "32 -w 8"; do
+    for r in $(seq "$REPEAT"); do
+      "$GRID" -j "$JITTER" -s "$SEED" -c "$CMD" -e "$TAIL" -n $size "$so" \
+        2>/dev/null || exit 1
+    done | awk -F, -v b=$batching -v t=$TAIL '!ns || $28 < ns { ns = $28 }
+      END { printf "%s,%u,%u,%u,%u,%.0f,%u,%.0f\n", b, $2, $10, $22, $26,
+        $22 * 1000 / t, ns, ns / ($26 ? $26 : 1) }'
+  done
+done
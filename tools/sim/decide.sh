@@ -0,0 +1,38 @@
+#!/bin/sh
+# Time to decision vs time to the last vote:  runs a single calculation on
+# jittered grids, healthy, with a FAULTY board and with a board powered off
+# just before the command (still counted in NODE_COUNT, never voting), and
+# prints one CSV table, the columns being the build and the case followed by
+# those of sim/grid.cpp.  final_* is when the boards' majority turned final,
+# last_vote_* when their last vote came in, and packets counts the 10 s after
+# the command.  Given a second board.so, built from before the majority could
+# turn final (e.g. make decide BEFORE=<revision>), the cases run on it too,
+# for its packets.
+#
+# usage:  decide.sh [grid binary] [board.so] [older board.so]
+
+GRID=${1:-build/grid}
+BOARD=${2:-build/board.so}
+BEFORE=$3
+CMD=${CMD:-c5000}
+JITTER=${JITTER:-3}
+SEED=${SEED:-1}
+
+header=-H
+for so in "$BOARD" $BEFORE; do
+  build=new
+  [ "$so" = "$BOARD" ] || build=old
+  while read name args; do
+    "$GRID" $header -j "$JITTER" -s "$SEED" -c "$CMD" $args "$so" \
+      2>/dev/null | sed "s/^topology,/build,case,&/;t;s/^/$build,$name,/" \
+      || exit 1
+    header=
+  done <<CASES
+4x4 -n 16 -w 4
+8x4 -n 32 -w 8
+8x8 -n 64 -w 8
+8x4-faulty -n 32 -w 8 -f 1
+4x4-off -n 16 -w 4 -k 5@9500
+8x4-off -n 32 -w 8 -k 5@9500
+CASES
+done
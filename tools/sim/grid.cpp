@@ -0,0 +1,999 @@
+/*
+ * Title:  grid
+ *
+ * Description:  Runs many copies of the unmodified suffrage sketch as
+ * simulated IXM boards wired into a line, ring, grid or torus, and reports
+ * how long each (c)alculation took to settle and what it cost in packets.
+ *
+ * Every board is its own copy of the sketch, built as a shared object
+ * (board.so) and loaded once per board from a copy of the file under a name
+ * of its own, so each copy gets its own globals.  The SFB calls the sketch makes are
+ * answered by sfb.cpp for the board current on the calling thread.
+ *
+ * Links deliver a line after the latency plus up to the jitter, or lose it.
+ * Like the serial links they stand in for, they never reorder lines.
+ * Boards are split across worker threads and run in lock-step windows as
+ * long as the latency:  nothing a board sends in a window can arrive before
+ * the next one, so the boards of a window run independently and the result
+ * does not depend on the thread count.  Loss, jitter and boot times are
+ * drawn from per-board generators seeded from the seed.  Handlers take no
+ * simulated time:  a calculation costs its boards the calcSlice_PERIOD of
+ * each slice it needs, not the CPU time of the slices.
+ *
+ * The terminal is a fifth port of one board, so it takes no link away in any
+ * topology.  The commands are sent to it one after the other, each counted
+ * from the moment it's sent.  For each one, a line of CSV reports:
+ *  - boards that settled on the most common majority, and that majority,
+ *  - percentiles of the time those boards took to settle on it (last
+ *    change of their MAJORITY_RSLT while on that version), of the time
+ *    their majority turned final (-1 for a sketch older than
+ *    MAJORITY_FINAL) and of the time their last vote came in,
+ *  - packets and bytes sent while it was the latest command, packets lost,
+ *  - the peak node table occupancy of any board,
+ *  - records the boards forwarded and duplicates they suppressed while it
+ *    was the latest command (FWD_FACE_ARR and SUP_FACE_ARR, 0 for a sketch
+ *    older than them), and the host time the boards took to run meanwhile
+ *    (the sketch's handlers and passing on what they sent), over all
+ *    threads.
+ *
+ * Usage:  grid [options] board.so
+ *  -t line|ring|grid|torus  topology (grid)
+ *  -n N        boards (16)
+ *  -w W        width of a grid or torus (the largest divisor of N up to
+ *              its square root)
+ *  -l MS       link latency (2), also the length of a window
+ *  -j MS       link jitter (0)
+ *  -p PCT      link loss in percent (0)
+ *  -f K        FAULTY boards (0)
+ *  -k B@MS     power board B off at MS, repeatable
+ *  -c CMDS     terminal commands, ';'-separated ("c1000")
+ *  -g MS       time between commands (5000)
+ *  -u MS       time before the first command, for the boards to meet (10000)
+ *  -e MS       time after the last command (10000)
+ *  -b B        board the terminal is on (0)
+ *  -B MS       boards power on over this long (1000)
+ *  -s SEED     seed (1)
+ *  -T THREADS  worker threads (1)
+ *  -r CMD      at the end, send CMD to every board (e.g. v or d)
+ *  -o FILE     terminal output of every board, prefixed with its index
+ *              (stderr)
+ *  -H          print the CSV header first
+ */
+
+#include <dlfcn.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "sim.h"
+
+const u32 NEVER = 0xffffffff;
+const u32 MSG_MAX = 128; // longest line a link carries
+const u32 ID_BASE = 1000; // boot block ID of board 0
+const u32 ID_STEP = 7; // between the boot block IDs of consecutive boards
+
+/* line on its way over a link */
+struct Msg
+{
+  u32 at; // arrival time
+  u32 dst; // board it arrives at
+  u32 src; // board it came from
+  u32 seq; // sent by src so far, orders lines that arrive together
+  u8 face; // face of dst it arrives on
+  u8 length;
+  char text[MSG_MAX];
+};
+
+struct MsgEarlier
+{
+  bool
+  operator()(const Msg & a, const Msg & b) const
+  {
+    if (a.at != b.at)
+      return a.at < b.at;
+    if (a.src != b.src)
+      return a.src < b.src;
+    return a.seq < b.seq;
+  }
+};
+
+/* what a board did while one version was its current one */
+struct Track
+{
+  u32 ver; // calculation version
+  u32 rslt; // majority it last settled on
+  u32 settled; // time of the last majority change
+  u32 final; // time the majority turned final
+  u32 lastVote; // time of the last vote counted
+};
+
+struct Node
+{
+  Board board;
+  void * so; // the board's copy of the sketch
+  void (*setup)();
+  u32 * hostCalcVer;
+  u32 * majority;
+  bool * final;
+  u32 * voteCount;
+  u32 * nodeCount;
+  bool * faulty;
+  u32 * forwarded; // FWD_FACE_ARR
+  u32 * suppressed; // SUP_FACE_ARR
+  u64 forwardedSeen, suppressedSeen; // their sums as last seen
+  u32 boot; // power-on time, NEVER once it did
+  u32 next; // earliest thing it has coming (see collect), windows before it are skipped
+  bool dead; // powered off for good
+  bool makeFaulty;
+  s32 link[FACE_COUNT]; // board on each face, -1 for none
+  u32 linkFree[FACE_COUNT]; // arrival time of the last line sent on each face
+  u32 rng;
+  u32 seq;
+  u32 votes; // VOTE_COUNT as last seen
+  u32 peakNodes;
+  std::vector<Msg> inbox; // lines on their way in, in order from inboxHead
+  u32 inboxHead;
+  std::vector<Track> track;
+  std::string terminal; // lines printed to the terminal port
+};
+
+/* work and traffic of one worker thread */
+struct Worker
+{
+  u32 first, last; // boards [first, last)
+  u32 next; // earliest event of its boards after the window
+  std::vector<std::vector<Msg> > outbox; // per destination worker
+  std::vector<u64> packets, bytes, lost, forwarded, suppressed; // per command
+  std::vector<u64> handlerNs; // per command
+  std::vector<u32> power; // power events:  board << 9 | on << 8
+};
+
+std::string SO_IMAGE; // board.so, copied for every board
+char SO_DIR[PATH_MAX]; // where the copies go
+std::vector<Node> NODES;
+std::vector<Worker> WORKERS;
+u32 LATENCY = 2, JITTER = 0, LOSS = 0; // LOSS in 1/1000000
+u32 WIN_START = 0, WIN_END = 0; // window being run
+u32 SLOT = 0; // command the traffic counts towards
+bool DONE = false;
+bool NO_FINAL = false; // MAJORITY_FINAL of sketches from before it existed
+u32 NO_FACES[FACE_COUNT] =
+  { 0 }; // FWD_FACE_ARR and SUP_FACE_ARR of sketches from before them
+pthread_barrier_t BARRIER;
+
+/*
+ * Summary:     xorshift32 step.
+ * Parameters:  Generator state.
+ * Return:      Next value.
+ */
+static u32
+draw(u32 * state)
+{
+  u32 x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+
+  return x;
+}
+
+/*
+ * Summary:     Wall clock.
+ * Parameters:  None.
+ * Return:      Milliseconds.
+ */
+static double
+wallMs()
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, 0);
+
+  return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+/*
+ * Summary:     Host clock, for timing the sketch's handlers.
+ * Parameters:  None.
+ * Return:      Nanoseconds.
+ */
+static u64
+hostNs()
+{
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+
+  return (u64) t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/*
+ * Summary:     Worker a board belongs to, a run of neighboring indexes each
+ *              (see the first and last of the workers in main()).
+ * Parameters:  Board index.
+ * Return:      Worker index.
+ */
+static u32
+owner(u32 b)
+{
+  return (u32) ((u64) b * WORKERS.size() / NODES.size());
+}
+
+/*
+ * Summary:     Looks up a global of a board's sketch, or gives up.
+ * Parameters:  Shared object, symbol.
+ * Return:      Its address.
+ */
+static void *
+symbol(void * so, const char * name)
+{
+  void * p = dlsym(so, name);
+
+  if (0 == p)
+    {
+      fprintf(stderr, "grid:  %s not found:  %s\n", name, dlerror());
+      exit(1);
+    }
+
+  return p;
+}
+
+/*
+ * Summary:     Loads a fresh copy of the sketch for a board, powered off
+ *              until its boot time.
+ * Parameters:  Board index.
+ * Return:      None.
+ */
+static void
+load(u32 b)
+{
+  Node & n = NODES[b];
+  static u32 copies = 0;
+  char path[PATH_MAX + 32];
+
+  snprintf(path, sizeof(path), "%s/board%u.so", SO_DIR, copies++);
+
+  FILE * f = fopen(path, "wb");
+
+  if ((0 == f) || (1 != fwrite(SO_IMAGE.data(), SO_IMAGE.size(), 1, f))
+      || (0 != fclose(f)))
+    {
+      perror(path);
+      exit(1);
+    }
+
+  u32 now = n.board.now;
+
+  if (0 != n.so)
+    dlclose(n.so);
+  boardInit(&n.board, ID_BASE + ID_STEP * b);
+  boardEnter(&n.board, now); // the sketch asks for its ID as it loads
+  n.so = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  unlink(path); // stays mapped
+  if (0 == n.so)
+    {
+      fprintf(stderr, "grid:  %s\n", dlerror());
+      exit(1);
+    }
+
+  n.setup = (void(*)()) symbol(n.so, "_Z5setupv");
+  n.hostCalcVer = (u32 *) symbol(n.so, "HOST_CALC_VER");
+  n.majority = (u32 *) symbol(n.so, "MAJORITY_RSLT");
+  n.final = (bool *) dlsym(n.so, "MAJORITY_FINAL");
+  if (0 == n.final)
+    n.final = &NO_FINAL; // older sketch, never final
+  n.voteCount = (u32 *) symbol(n.so, "VOTE_COUNT");
+  n.nodeCount = (u32 *) symbol(n.so, "NODE_COUNT");
+  n.faulty = (bool *) symbol(n.so, "FAULTY");
+  n.forwarded = (u32 *) dlsym(n.so, "FWD_FACE_ARR");
+  if (0 == n.forwarded)
+    n.forwarded = NO_FACES;
+  n.suppressed = (u32 *) dlsym(n.so, "SUP_FACE_ARR");
+  if (0 == n.suppressed)
+    n.suppressed = NO_FACES;
+  n.forwardedSeen = 0; // a fresh copy counts from 0
+  n.suppressedSeen = 0;
+  n.votes = 0;
+
+  return;
+}
+
+/*
+ * Summary:     Sends what a board printed on its way:  over its links, to
+ *              its terminal, and its powerOut() calls to its neighbors.
+ * Parameters:  Worker, board index.
+ * Return:      None.
+ */
+static void
+route(Worker & w, u32 b)
+{
+  Node & n = NODES[b];
+  u32 now = n.board.now;
+  u64 forwarded = 0, suppressed = 0;
+
+  for (u32 i = 0; i < FACE_COUNT; ++i)
+    {
+      forwarded += n.forwarded[i];
+      suppressed += n.suppressed[i];
+    }
+  w.forwarded[SLOT] += forwarded - n.forwardedSeen;
+  w.suppressed[SLOT] += suppressed - n.suppressedSeen;
+  n.forwardedSeen = forwarded;
+  n.suppressedSeen = suppressed;
+
+  for (u32 i = 0; i < n.board.sent.size(); ++i)
+    {
+      SimLine & line = n.board.sent[i];
+
+      if (TERMINAL_PORT == line.face)
+        {
+          n.terminal.append(n.board.sentText, line.start, line.length);
+          continue;
+        }
+
+      if (n.link[line.face] < 0)
+        continue; // nothing plugged in there
+
+      ++w.packets[SLOT];
+      w.bytes[SLOT] += line.length;
+      if ((0 != LOSS) && (draw(&n.rng) % 1000000 < LOSS))
+        {
+          ++w.lost[SLOT];
+          continue;
+        }
+
+      Msg m;
+
+      m.at = now + LATENCY + ((0 != JITTER) ? draw(&n.rng) % (JITTER + 1) : 0);
+      m.at = n.linkFree[line.face] = std::max(m.at, n.linkFree[line.face]);
+      m.dst = n.link[line.face];
+      m.src = b;
+      m.seq = n.seq++;
+      m.face = (line.face + 2) % FACE_COUNT;
+      m.length = line.length;
+      if (line.length > MSG_MAX)
+        {
+          fprintf(stderr, "grid:  board %u sent a line of %u characters\n", b,
+              line.length);
+          exit(1);
+        }
+      memcpy(m.text, n.board.sentText.data() + line.start, line.length);
+      w.outbox[owner(m.dst)].push_back(m);
+    }
+  boardTake(&n.board);
+
+  for (u32 i = 0; i < n.board.power.size(); ++i)
+    {
+      u32 face = n.board.power[i] & 0xff;
+
+      if ((face < FACE_COUNT) && (0 <= n.link[face]))
+        w.power.push_back(((u32) n.link[face] << 9) | (n.board.power[i]
+            & 0x100));
+    }
+  n.board.power.clear();
+
+  return;
+}
+
+/*
+ * Summary:     Notes what changed on a board's vote state.
+ * Parameters:  Board index.
+ * Return:      None.
+ */
+static void
+observe(u32 b)
+{
+  Node & n = NODES[b];
+  u32 now = n.board.now;
+
+  if (n.track.empty() || (n.track.back().ver != *n.hostCalcVer))
+    {
+      Track t;
+
+      t.ver = *n.hostCalcVer;
+      t.rslt = *n.majority;
+      t.settled = now;
+      t.final = NEVER;
+      t.lastVote = NEVER;
+      n.track.push_back(t);
+      n.votes = 0;
+    }
+
+  Track & t = n.track.back();
+
+  if (*n.majority != t.rslt)
+    {
+      t.rslt = *n.majority;
+      t.settled = now;
+    }
+  if (*n.final && (NEVER == t.final))
+    t.final = now;
+  if (*n.voteCount > n.votes)
+    t.lastVote = now;
+  n.votes = *n.voteCount;
+  n.peakNodes = std::max(n.peakNodes, *n.nodeCount);
+
+  return;
+}
+
+/*
+ * Summary:     Runs a board's boot, alarms and deliveries in time order
+ *              until the end of the window.
+ * Parameters:  Worker, board index.
+ * Return:      None.
+ */
+static void
+runBoard(Worker & w, u32 b)
+{
+  Node & n = NODES[b];
+
+  if (n.dead || (n.next >= WIN_END))
+    return; // nothing to do in this window
+
+  u64 start = hostNs();
+
+  if ((NEVER != n.boot) && (n.boot < WIN_END))
+    {
+      n.board.epoch = n.boot;
+      boardEnter(&n.board, n.boot);
+      n.setup();
+      if (n.makeFaulty)
+        *n.faulty = true;
+      n.boot = NEVER;
+      route(w, b);
+    }
+  if (NEVER != n.boot)
+    return; // still dark
+
+  for (;;)
+    {
+      u32 alarmAt = NEVER;
+      u32 alarm = boardNextAlarm(&n.board, &alarmAt);
+      u32 msgAt = (n.inboxHead < n.inbox.size()) ? n.inbox[n.inboxHead].at
+          : NEVER;
+
+      if ((msgAt < WIN_END) && (msgAt <= alarmAt))
+        {
+          Msg & m = n.inbox[n.inboxHead++];
+
+          boardDeliver(&n.board, m.at, m.face, m.text, m.length);
+        }
+      else if ((0 != alarm) && (alarmAt < WIN_END))
+        boardFire(&n.board, alarm);
+      else
+        break;
+
+      route(w, b);
+      observe(b);
+    }
+  w.handlerNs[SLOT] += hostNs() - start;
+
+  if (n.inboxHead * 2 >= n.inbox.size())
+    { // drop what was delivered, now and then
+      n.inbox.erase(n.inbox.begin(), n.inbox.begin() + n.inboxHead);
+      n.inboxHead = 0;
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Earliest thing a board has coming.
+ * Parameters:  Board index.
+ * Return:      Its time, NEVER if nothing.
+ */
+static u32
+nextEvent(u32 b)
+{
+  Node & n = NODES[b];
+  u32 alarmAt = NEVER;
+
+  if (n.dead)
+    return NEVER;
+  if (NEVER != n.boot)
+    return n.boot;
+  if (0 == boardNextAlarm(&n.board, &alarmAt))
+    alarmAt = NEVER;
+
+  return (n.inboxHead < n.inbox.size()) ? std::min(alarmAt,
+      n.inbox[n.inboxHead].at) : alarmAt;
+}
+
+/*
+ * Summary:     Takes in the lines sent to a worker's boards in the window
+ *              just run, and finds the earliest thing they have coming.
+ * Parameters:  Worker index.
+ * Return:      None.
+ */
+static void
+collect(u32 me)
+{
+  Worker & w = WORKERS[me];
+
+  for (u32 from = 0; from < WORKERS.size(); ++from)
+    {
+      std::vector<Msg> & box = WORKERS[from].outbox[me];
+
+      for (u32 i = 0; i < box.size(); ++i)
+        {
+          Node & n = NODES[box[i].dst];
+
+          if (n.inboxHead == n.inbox.size())
+            {
+              n.inbox.clear();
+              n.inboxHead = 0;
+            }
+          n.inbox.push_back(box[i]);
+        }
+      box.clear();
+    }
+
+  w.next = NEVER;
+  for (u32 b = w.first; b < w.last; ++b)
+    {
+      Node & n = NODES[b];
+
+      std::sort(n.inbox.begin() + n.inboxHead, n.inbox.end(), MsgEarlier());
+      n.next = nextEvent(b);
+      w.next = std::min(w.next, n.next);
+    }
+
+  return;
+}
+
+/*
+ * Summary:     Worker thread:  runs its boards window by window.  The main
+ *              thread is worker 0, and plans the windows between the
+ *              barriers.
+ * Parameters:  Worker index.
+ * Return:      None.
+ */
+static void *
+work(void * arg)
+{
+  u32 me = (u32) (size_t) arg;
+
+  for (;;)
+    {
+      pthread_barrier_wait(&BARRIER); // window planned
+      if (DONE)
+        break;
+      for (u32 b = WORKERS[me].first; b < WORKERS[me].last; ++b)
+        runBoard(WORKERS[me], b);
+      pthread_barrier_wait(&BARRIER); // window run
+      collect(me);
+      pthread_barrier_wait(&BARRIER); // lines taken in
+    }
+
+  return 0;
+}
+
+/*
+ * Summary:     Nearest-rank percentile.
+ * Parameters:  Sorted values, percentile.
+ * Return:      The value, -1 if there are none.
+ */
+static long
+percentile(const std::vector<u32> & v, u32 pct)
+{
+  if (v.empty())
+    return -1;
+
+  size_t rank = (v.size() * pct + 99) / 100;
+
+  return v[(0 < rank) ? rank - 1 : 0];
+}
+
+int
+main(int argc, char ** argv)
+{
+  const char * topology = "grid";
+  u32 count = 16, width = 0, faulty = 0, gap = 5000, warmup = 10000;
+  u32 tail = 10000, terminal = 0, spread = 1000, seed = 1, threads = 1;
+  std::string commands = "c1000", report;
+  std::vector<std::pair<u32, u32> > kills; // board, time
+  FILE * out = stderr;
+  bool header = false;
+  int opt;
+
+  while (-1 != (opt = getopt(argc, argv, "t:n:w:l:j:p:f:k:c:g:u:e:b:B:s:T:r:o:H")))
+    switch (opt)
+      {
+    case 't':
+      topology = optarg;
+      break;
+    case 'n':
+      count = atoi(optarg);
+      break;
+    case 'w':
+      width = atoi(optarg);
+      break;
+    case 'l':
+      LATENCY = atoi(optarg);
+      break;
+    case 'j':
+      JITTER = atoi(optarg);
+      break;
+    case 'p':
+      LOSS = (u32) (atof(optarg) * 10000 + 0.5);
+      break;
+    case 'f':
+      faulty = atoi(optarg);
+      break;
+    case 'k':
+      {
+        const char * at = strchr(optarg, '@');
+
+        kills.push_back(std::make_pair((u32) atoi(optarg), (u32) (at ? atoi(at
+            + 1) : 0)));
+        break;
+      }
+    case 'c':
+      commands = optarg;
+      break;
+    case 'g':
+      gap = atoi(optarg);
+      break;
+    case 'u':
+      warmup = atoi(optarg);
+      break;
+    case 'e':
+      tail = atoi(optarg);
+      break;
+    case 'b':
+      terminal = atoi(optarg);
+      break;
+    case 'B':
+      spread = atoi(optarg);
+      break;
+    case 's':
+      seed = atoi(optarg);
+      break;
+    case 'T':
+      threads = atoi(optarg);
+      break;
+    case 'r':
+      report = optarg;
+      break;
+    case 'o':
+      out = fopen(optarg, "w");
+      if (0 == out)
+        {
+          perror(optarg);
+          return 1;
+        }
+      break;
+    case 'H':
+      header = true;
+      break;
+    default:
+      fprintf(stderr, "usage:  see the top of grid.cpp\n");
+      return 1;
+      }
+
+  if ((optind + 1 != argc) || (0 == count) || (0 == LATENCY) || (terminal
+      >= count) || (faulty > count))
+    {
+      fprintf(stderr, "usage:  grid [options] board.so (see grid.cpp)\n");
+      return 1;
+    }
+
+  FILE * so = fopen(argv[optind], "rb");
+  char chunk[65536];
+  size_t got;
+
+  if (0 == so)
+    {
+      perror(argv[optind]);
+      return 1;
+    }
+  while (0 < (got = fread(chunk, 1, sizeof(chunk), so)))
+    SO_IMAGE.append(chunk, got);
+  fclose(so);
+  snprintf(SO_DIR, sizeof(SO_DIR), "%s/grid.XXXXXX", getenv("TMPDIR")
+      ? getenv("TMPDIR") : "/tmp");
+  if (0 == mkdtemp(SO_DIR))
+    {
+      perror(SO_DIR);
+      return 1;
+    }
+
+  /* wire up the topology, faces being 0 north, 1 east, 2 south, 3 west */
+  std::string topo = topology;
+  bool wrap = ("ring" == topo) || ("torus" == topo);
+  u32 height = 1;
+
+  if (("grid" == topo) || ("torus" == topo))
+    {
+      if (0 == width)
+        for (width = (u32) sqrt((double) count); count % width; --width)
+          ;
+      height = count / width;
+    }
+  else if (("line" == topo) || ("ring" == topo))
+    width = count;
+  else
+    {
+      fprintf(stderr, "grid:  unknown topology %s\n", topology);
+      return 1;
+    }
+  if ((0 == width) || (width * height != count) || (wrap && ((width == 2)
+      || (height == 2))))
+    {
+      fprintf(stderr, "grid:  %u boards don't make a %s %u wide\n", count,
+          topology, width);
+      return 1;
+    }
+
+  NODES.resize(count);
+  for (u32 b = 0; b < count; ++b)
+    {
+      Node & n = NODES[b];
+      u32 x = b % width, y = b / width;
+
+      n.so = 0;
+      n.dead = false;
+      n.makeFaulty = false;
+      n.rng = (seed * 2654435761u) ^ ((b + 1) * 2246822519u);
+      if (0 == n.rng)
+        n.rng = 1;
+      n.seq = 0;
+      n.peakNodes = 0;
+      n.inboxHead = 0;
+      for (u32 f = 0; f < FACE_COUNT; ++f)
+        n.linkFree[f] = 0;
+      n.link[0] = (0 < y) ? (s32) (b - width) : ((wrap && 1 < height) ? (s32) (b
+          + width * (height - 1)) : -1);
+      n.link[2] = (y + 1 < height) ? (s32) (b + width) : ((wrap && 1 < height)
+          ? (s32) x : -1);
+      n.link[1] = (x + 1 < width) ? (s32) (b + 1) : (wrap ? (s32) (b + 1
+          - width) : -1);
+      n.link[3] = (0 < x) ? (s32) (b - 1) : (wrap ? (s32) (b + width - 1) : -1);
+      load(b);
+      n.boot = (0 != spread) ? draw(&n.rng) % spread : 0;
+      n.next = n.boot;
+    }
+
+  /* pick the FAULTY boards, the same ones for a seed whatever the rest */
+  u32 pick = seed | 1;
+
+  for (u32 k = 0; k < faulty;)
+    {
+      u32 b = draw(&pick) % count;
+
+      if (!NODES[b].makeFaulty)
+        {
+          NODES[b].makeFaulty = true;
+          ++k;
+        }
+    }
+
+  std::vector<std::string> cmds;
+
+  for (size_t p = 0; p <= commands.size();)
+    {
+      size_t q = commands.find(';', p);
+
+      if (std::string::npos == q)
+        q = commands.size();
+      if (q > p)
+        cmds.push_back(commands.substr(p, q - p) + "\n");
+      p = q + 1;
+    }
+
+  threads = std::max(1u, std::min(threads, count));
+  WORKERS.resize(threads);
+  for (u32 i = 0; i < threads; ++i)
+    {
+      WORKERS[i].first = (u32) (((u64) count * i + threads - 1) / threads);
+      WORKERS[i].last = (u32) (((u64) count * (i + 1) + threads - 1) / threads);
+      WORKERS[i].outbox.resize(threads);
+      WORKERS[i].packets.assign(cmds.size() + 1, 0);
+      WORKERS[i].bytes.assign(cmds.size() + 1, 0);
+      WORKERS[i].lost.assign(cmds.size() + 1, 0);
+      WORKERS[i].forwarded.assign(cmds.size() + 1, 0);
+      WORKERS[i].suppressed.assign(cmds.size() + 1, 0);
+      WORKERS[i].handlerNs.assign(cmds.size() + 1, 0);
+    }
+  pthread_barrier_init(&BARRIER, 0, threads);
+  std::vector<pthread_t> tids(threads);
+
+  for (u32 i = 1; i < threads; ++i)
+    pthread_create(&tids[i], 0, work, (void *) (size_t) i);
+
+  /* run the windows */
+  std::vector<u32> cmdAt(cmds.size()), cmdVer(cmds.size(), 0);
+  u32 end = warmup + gap * (cmds.empty() ? 0 : cmds.size() - 1) + tail;
+  u32 nextCmd = 0;
+  double wall = wallMs();
+
+  for (u32 k = 0; k < cmds.size(); ++k)
+    cmdAt[k] = warmup + gap * k;
+
+  WIN_START = 0;
+  for (;;)
+    {
+      for (u32 i = 0; i < kills.size(); ++i)
+        if ((kills[i].second <= WIN_START) && !NODES[kills[i].first].dead)
+          {
+            NODES[kills[i].first].dead = true;
+            NODES[kills[i].first].board.off = true;
+          }
+
+      if ((nextCmd < cmds.size()) && (cmdAt[nextCmd] <= WIN_START))
+        { // the terminal's line arrives now
+          Node & n = NODES[terminal];
+
+          SLOT = nextCmd + 1;
+          boardDeliver(&n.board, WIN_START, TERMINAL_PORT, cmds[nextCmd]);
+          route(WORKERS[owner(terminal)], terminal);
+          observe(terminal);
+          n.next = nextEvent(terminal); // what the command set off
+          cmdVer[nextCmd] = *n.hostCalcVer;
+          cmdAt[nextCmd++] = WIN_START;
+        }
+
+      DONE = (WIN_START >= end);
+      WIN_END = std::min(WIN_START + LATENCY, end);
+      if ((nextCmd < cmds.size()) && (cmdAt[nextCmd] < WIN_END))
+        WIN_END = std::max(WIN_START + 1, cmdAt[nextCmd]);
+      for (u32 i = 0; i < kills.size(); ++i)
+        if ((kills[i].second > WIN_START) && (kills[i].second < WIN_END))
+          WIN_END = kills[i].second;
+
+      pthread_barrier_wait(&BARRIER); // window planned
+      if (DONE)
+        break;
+      for (u32 b = WORKERS[0].first; b < WORKERS[0].last; ++b)
+        runBoard(WORKERS[0], b);
+      pthread_barrier_wait(&BARRIER); // window run
+      collect(0);
+      pthread_barrier_wait(&BARRIER); // lines taken in
+
+      /* power events, then skip ahead over windows with nothing in them */
+      u32 next = NEVER;
+
+      for (u32 i = 0; i < threads; ++i)
+        {
+          next = std::min(next, WORKERS[i].next);
+          for (u32 j = 0; j < WORKERS[i].power.size(); ++j)
+            {
+              u32 b = WORKERS[i].power[j] >> 9;
+              Node & n = NODES[b];
+
+              if (n.dead)
+                continue;
+              if (0 == (WORKERS[i].power[j] & 0x100))
+                n.board.off = true;
+              else if (n.board.off)
+                { // powered back on:  a fresh sketch boots
+                  n.inbox.clear();
+                  n.inboxHead = 0;
+                  load(b);
+                  n.boot = n.next = WIN_END;
+                  next = std::min(next, WIN_END);
+                }
+            }
+          WORKERS[i].power.clear();
+        }
+
+      WIN_START = WIN_END;
+      if (next > WIN_START)
+        WIN_START = std::min(next, (nextCmd < cmds.size()) ? cmdAt[nextCmd]
+            : end);
+      for (u32 i = 0; i < kills.size(); ++i)
+        if ((kills[i].second > WIN_END) && (kills[i].second < WIN_START))
+          WIN_START = kills[i].second;
+    }
+  for (u32 i = 1; i < threads; ++i)
+    pthread_join(tids[i], 0);
+  wall = wallMs() - wall;
+  rmdir(SO_DIR);
+
+  /* ask every board for a report */
+  if (!report.empty())
+    for (u32 b = 0; b < count; ++b)
+      if (!NODES[b].dead && !NODES[b].board.off)
+        {
+          boardDeliver(&NODES[b].board, end, TERMINAL_PORT, report + "\n");
+          route(WORKERS[0], b);
+        }
+  for (u32 b = 0; b < count; ++b)
+    for (size_t p = 0, q; std::string::npos != (q = NODES[b].terminal.find(
+        '\n', p)); p = q + 1)
+      fprintf(out, "%u:%s\n", b, NODES[b].terminal.substr(p, q - p).c_str());
+
+  /* one CSV line per command */
+  if (header)
+    printf("topology,boards,latency_ms,jitter_ms,loss_pct,faulty,seed,cmd,"
+      "ver,agreed,majority,settle_p50_ms,settle_p90_ms,settle_p99_ms,"
+      "settle_max_ms,final_p50_ms,final_p90_ms,final_max_ms,"
+      "last_vote_p50_ms,last_vote_p90_ms,last_vote_max_ms,packets,bytes,lost,"
+      "peak_nodes,forwarded,suppressed,handler_ns\n");
+
+  u32 peak = 0;
+
+  for (u32 b = 0; b < count; ++b)
+    peak = std::max(peak, NODES[b].peakNodes);
+
+  for (u32 k = 0; k < cmds.size(); ++k)
+    {
+      std::vector<u32> rslts, settle, fin, last;
+      u32 majority = 0, agreed = 0;
+      u64 packets = 0, bytes = 0, lost = 0, forwarded = 0, suppressed = 0;
+      u64 handlerNs = 0;
+
+      for (u32 b = 0; b < count; ++b)
+        for (u32 i = 0; i < NODES[b].track.size(); ++i)
+          if (cmdVer[k] == NODES[b].track[i].ver)
+            rslts.push_back(NODES[b].track[i].rslt);
+      std::sort(rslts.begin(), rslts.end());
+      for (u32 i = 0, run = 0; i < rslts.size(); ++i)
+        {
+          run = ((0 < i) && (rslts[i] == rslts[i - 1])) ? run + 1 : 1;
+          if (run > agreed)
+            {
+              agreed = run;
+              majority = rslts[i];
+            }
+        }
+
+      for (u32 b = 0; b < count; ++b)
+        for (u32 i = 0; i < NODES[b].track.size(); ++i)
+          {
+            Track & t = NODES[b].track[i];
+
+            if ((cmdVer[k] != t.ver) || (majority != t.rslt))
+              continue;
+            settle.push_back(t.settled - cmdAt[k]);
+            if (NEVER != t.final)
+              fin.push_back(t.final - cmdAt[k]);
+            if (NEVER != t.lastVote)
+              last.push_back(t.lastVote - cmdAt[k]);
+          }
+      std::sort(settle.begin(), settle.end());
+      std::sort(fin.begin(), fin.end());
+      std::sort(last.begin(), last.end());
+
+      for (u32 i = 0; i < threads; ++i)
+        {
+          packets += WORKERS[i].packets[k + 1];
+          bytes += WORKERS[i].bytes[k + 1];
+          lost += WORKERS[i].lost[k + 1];
+          forwarded += WORKERS[i].forwarded[k + 1];
+          suppressed += WORKERS[i].suppressed[k + 1];
+          handlerNs += WORKERS[i].handlerNs[k + 1];
+        }
+
+      std::string cmd = cmds[k].substr(0, cmds[k].size() - 1);
+
+      if (std::string::npos != cmd.find(','))
+        cmd = "\"" + cmd + "\"";
+      printf("%s,%u,%u,%u,%g,%u,%u,%s,%u,%u,%u,%ld,%ld,%ld,%ld,%ld,%ld,%ld,"
+        "%ld,%ld,%ld,%llu,%llu,%llu,%u,%llu,%llu,%llu\n", topology, count, LATENCY, JITTER, LOSS
+          / 10000.0, faulty, seed, cmd.c_str(), cmdVer[k], agreed, majority,
+          percentile(settle, 50), percentile(settle, 90), percentile(settle,
+              99), percentile(settle, 100), percentile(fin, 50), percentile(
+              fin, 90), percentile(fin, 100), percentile(last, 50),
+          percentile(last, 90), percentile(last, 100),
+          (unsigned long long) packets, (unsigned long long) bytes,
+          (unsigned long long) lost, peak, (unsigned long long) forwarded,
+          (unsigned long long) suppressed, (unsigned long long) handlerNs);
+    }
+
+  fprintf(stderr, "grid:  %u boards, %u ms simulated in %.0f ms (%.1fx), "
+    "%u thread(s)\n", count, end, wall, end / std::max(wall, 1.0), threads);
+
+  return 0;
+}
@@ -0,0 +1,612 @@
+/*
+ * Title:  sfb
+ *
+ * Description:  The SFB calls of sfb.h and the board* functions of sim.h.
+ * Everything acts on simBoard;  a program that never sets it (a host test
+ * linking the sketch in directly) gets one board of its own on first use.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "sim.h"
+
+__thread Board * simBoard = 0;
+AlarmsT Alarms;
+BodyT Body;
+
+const u32 SIM_DEFAULT_ID = 1; // boot block ID of the board a host test gets
+
+/*
+ * Summary:     Board the SFB calls act on, making one up for programs that
+ *              never set simBoard.
+ * Parameters:  None.
+ * Return:      Current board.
+ */
+static Board *
+current()
+{
+  if (0 == simBoard)
+    {
+      static Board * lone = 0;
+
+      if (0 == lone)
+        {
+          lone = new Board;
+          boardInit(lone, SIM_DEFAULT_ID);
+          lone->log = (0 != getenv("SIM_LOG"));
+        }
+      simBoard = lone;
+    }
+
+  return simBoard;
+}
+
+/*
+ * Summary:     Resets a board to power-on:  no alarms, reflexes or output.
+ * Parameters:  Board, its boot block ID.
+ * Return:      None.
+ */
+void
+boardInit(Board * board, u32 id)
+{
+  board->id = id;
+  board->now = 0;
+  board->epoch = 0;
+  board->off = false;
+  board->rebooted = false;
+  board->reboots = 0;
+  board->alarmCount = 0;
+  board->alarmCurrent = 0;
+  for (u32 a = 0; a <= ALARM_MAX; ++a)
+    {
+      board->alarmFn[a] = 0;
+      board->alarmAt[a] = 0;
+      board->alarmSet[a] = false;
+    }
+  for (u32 c = 0; c < 256; ++c)
+    board->reflexFn[c] = 0;
+  for (u32 l = 0; l < 3; ++l)
+    board->led[l] = false;
+  board->log = false;
+  for (u32 f = 0; f <= FACE_COUNT; ++f)
+    board->partial[f].clear();
+  board->sent.clear();
+  board->sentText.clear();
+  board->power.clear();
+
+  return;
+}
+
+/*
+ * Summary:     Makes a board current on this thread, its clock no earlier
+ *              than the given time.
+ * Parameters:  Board, time (ms).
+ * Return:      None.
+ */
+void
+boardEnter(Board * board, u32 now)
+{
+  simBoard = board;
+  if (now > board->now)
+    board->now = now;
+
+  return;
+}
+
+/*
+ * Summary:     Hands a line to the reflex registered for its first character.
+ * Parameters:  Board, arrival time (ms), face it came in on, the line and
+ *              its length.
+ * Return:      Whether a reflex took it.
+ */
+bool
+boardDeliver(Board * board, u32 when, u8 source, const char * text,
+    u32 length)
+{
+  if (board->off || (0 == length) || (0 == board->reflexFn[(u8) text[0]]))
+    return false;
+
+  SimPacket packet;
+
+  packet.text = text;
+  packet.length = length;
+  packet.cursor = 0;
+  packet.source = source;
+  boardEnter(board, when);
+  board->reflexFn[(u8) text[0]]((u8 *) &packet);
+
+  return true;
+}
+
+bool
+boardDeliver(Board * board, u32 when, u8 source, const std::string & text)
+{
+  return boardDeliver(board, when, source, text.data(), text.size());
+}
+
+/*
+ * Summary:     Text of a line the board printed.
+ * Parameters:  Board, index in sent.
+ * Return:      The line, '\n' included.
+ */
+std::string
+boardLine(const Board * board, u32 line)
+{
+  return board->sentText.substr(board->sent[line].start,
+      board->sent[line].length);
+}
+
+/*
+ * Summary:     Forgets the lines the board printed, once the driver has
+ *              taken them.
+ * Parameters:  Board.
+ * Return:      None.
+ */
+void
+boardTake(Board * board)
+{
+  board->sent.clear();
+  board->sentText.clear();
+
+  return;
+}
+
+/*
+ * Summary:     Finds the alarm that goes off next.
+ * Parameters:  Board, where to put its time (ms).
+ * Return:      Alarm number, 0 if none is set.
+ */
+u32
+boardNextAlarm(Board * board, u32 * when)
+{
+  u32 next = 0;
+
+  for (u32 a = 1; a <= board->alarmCount; ++a)
+    if (board->alarmSet[a] && ((0 == next) || (board->alarmAt[a]
+        < board->alarmAt[next])))
+      next = a;
+
+  if (0 != next)
+    *when = board->alarmAt[next];
+
+  return next;
+}
+
+/*
+ * Summary:     Runs an alarm's handler at the time it was set for, passing
+ *              it that time on the board's clock.
+ * Parameters:  Board, alarm number.
+ * Return:      None.
+ */
+void
+boardFire(Board * board, u32 alarm)
+{
+  u32 when = board->alarmAt[alarm];
+
+  board->alarmSet[alarm] = false;
+  board->alarmCurrent = alarm;
+  boardEnter(board, when);
+  board->alarmFn[alarm](when - board->epoch);
+  board->alarmCurrent = 0;
+
+  return;
+}
+
+/*
+ * Summary:     Fires a lone board's alarms in order until the given time.
+ * Parameters:  Board, time to stop at (ms).
+ * Return:      None.
+ */
+void
+boardRun(Board * board, u32 until)
+{
+  u32 when = 0;
+
+  for (u32 a = boardNextAlarm(board, &when); (0 != a) && (when <= until)
+      && !board->off; a = boardNextAlarm(board, &when))
+    boardFire(board, a);
+
+  boardEnter(board, until);
+
+  return;
+}
+
+u32
+AlarmsT::create(AlarmHandler handler)
+{
+  Board * b = current();
+
+  API_ASSERT(b->alarmCount < ALARM_MAX, E_API_LESS);
+  b->alarmFn[++b->alarmCount] = handler;
+
+  return b->alarmCount;
+}
+
+void
+AlarmsT::set(u32 alarm, u32 when)
+{
+  Board * b = current();
+
+  API_ASSERT((0 < alarm) && (alarm <= b->alarmCount), E_API_LESS);
+  b->alarmAt[alarm] = when + b->epoch;
+  b->alarmSet[alarm] = true;
+
+  return;
+}
+
+u32
+AlarmsT::currentAlarmNumber()
+{
+  return current()->alarmCurrent;
+}
+
+void
+BodyT::reflex(u8 code, ReflexHandler handler)
+{
+  current()->reflexFn[code] = handler;
+
+  return;
+}
+
+void
+sfbDie(const char * file, int line, int code)
+{
+  fprintf(stderr, "%s:%d: blinkcode %d on board %u\n", file, line, code,
+      current()->id);
+  abort();
+}
+
+u32
+getBootBlockBoardId()
+{
+  return current()->id;
+}
+
+void
+logNormal(const char * format, ...)
+{
+  Board * b = current();
+
+  if (!b->log)
+    return;
+
+  va_list ap;
+
+  va_start(ap, format);
+  fprintf(stderr, "%u %u: ", b->now, b->id);
+  vfprintf(stderr, format, ap);
+  va_end(ap);
+
+  return;
+}
+
+void
+ledOn(u32 pin)
+{
+  current()->led[pin % 3] = true;
+
+  return;
+}
+
+void
+ledOff(u32 pin)
+{
+  current()->led[pin % 3] = false;
+
+  return;
+}
+
+bool
+ledIsOn(u32 pin)
+{
+  return current()->led[pin % 3];
+}
+
+bool
+buttonDown()
+{
+  return false;
+}
+
+/*
+ * Summary:     Formats one number in the given base, lower-case, ending at
+ *              the given end of a buffer.
+ * Parameters:  Value, base, end of the buffer.
+ * Return:      First character written.
+ */
+static char *
+digits(u32 value, u32 base, char * end)
+{
+  const char * DIGITS = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+  if (10 == base) // the common case, divided by a constant
+    do
+      {
+        *--end = DIGITS[value % 10];
+        value /= 10;
+      }
+    while (0 != value);
+  else
+    do
+      {
+        *--end = DIGITS[value % base];
+        value /= base;
+      }
+    while (0 != value);
+
+  return end;
+}
+
+/*
+ * Summary:     facePrintf() for one face:  appends to the face's partial line
+ *              and moves every completed line to sent.
+ * Parameters:  Face, format, arguments.
+ * Return:      None.
+ */
+static void
+facePrint(u8 face, const char * format, va_list ap)
+{
+  Board * b = current();
+  std::string & out = b->partial[face];
+  PrinterFn printer = 0;
+
+  for (const char * f = format; *f; ++f)
+    {
+      const char * plain = f;
+
+      while (*f && ('%' != *f))
+        ++f;
+      out.append(plain, f - plain);
+      if (!*f)
+        break;
+
+      bool left = false;
+      bool zero = false;
+      int width = 0;
+      char buf[40];
+      char * end = buf + sizeof(buf);
+      const char * v = end;
+
+      for (++f; ('-' == *f) || ('0' == *f); ++f)
+        (('-' == *f) ? left : zero) = true;
+      while (isdigit(*f))
+        width = width * 10 + (*f++ - '0');
+
+      switch (*f)
+        {
+      case 'd':
+        {
+          s32 x = va_arg(ap, s32);
+
+          v = digits((x < 0) ? -(u32) x : x, 10, end);
+          if (x < 0)
+            *(char *) --v = '-';
+          break;
+        }
+      case 'u':
+        v = digits(va_arg(ap, u32), 10, end);
+        break;
+      case 'x':
+        v = digits(va_arg(ap, u32), 16, end);
+        break;
+      case 't':
+        v = digits(va_arg(ap, u32), 36, end);
+        break;
+      case 's':
+        v = va_arg(ap, const char *);
+        end = (char *) v + strlen(v);
+        break;
+      case 'c':
+        buf[0] = (char) va_arg(ap, int);
+        v = buf;
+        end = buf + 1;
+        break;
+      case 'Z':
+        printer = va_arg(ap, PrinterFn);
+        continue;
+      case 'z':
+        printer(face, va_arg(ap, void *), false, width, zero);
+        continue;
+      default:
+        v = f;
+        end = (char *) f + 1;
+        break;
+        }
+
+      int pad = width - (end - v);
+
+      if ((0 < pad) && !left)
+        out.append(pad, zero ? '0' : ' ');
+      out.append(v, end - v);
+      if ((0 < pad) && left)
+        out.append(pad, ' ');
+    }
+
+  for (size_t nl = out.find('\n'); std::string::npos != nl; nl = out.find('\n'))
+    {
+      SimLine line;
+
+      line.face = face;
+      line.start = b->sentText.size();
+      line.length = nl + 1;
+      b->sentText.append(out, 0, nl + 1);
+      out.erase(0, nl + 1);
+      b->sent.push_back(line);
+    }
+
+  return;
+}
+
+void
+facePrintf(u8 face, const char * format, ...)
+{
+  va_list ap;
+
+  va_start(ap, format);
+  if (ALL_FACES == face)
+    for (u8 f = 0; f < FACE_COUNT; ++f)
+      {
+        va_list each;
+
+        va_copy(each, ap);
+        facePrint(f, format, each);
+        va_end(each);
+      }
+  else
+    facePrint((face < FACE_COUNT) ? face : TERMINAL_PORT, format, ap);
+  va_end(ap);
+
+  return;
+}
+
+void
+facePrintln(u8 face, const char * format, ...)
+{
+  va_list ap;
+
+  va_start(ap, format);
+  facePrint((face < FACE_COUNT) ? face : TERMINAL_PORT, format, ap);
+  va_end(ap);
+  facePrintf(face, "\n");
+
+  return;
+}
+
+int
+packetScanf(u8 * packet, const char * format, ...)
+{
+  SimPacket * p = (SimPacket *) packet;
+  const char * s = p->text;
+  ScannerFn scanner = 0;
+  int n = 0;
+  va_list ap;
+
+  va_start(ap, format);
+  for (const char * f = format; *f; ++f)
+    {
+      if ('%' != *f)
+        { // literals count as matches, the way the SFB does it
+          if ((p->cursor >= p->length) || (s[p->cursor] != *f))
+            break;
+          ++p->cursor;
+          ++n;
+          continue;
+        }
+
+      ++f;
+      if ('Z' == *f)
+        {
+          scanner = va_arg(ap, ScannerFn);
+          continue;
+        }
+      if ('z' == *f)
+        {
+          if (!scanner(packet, va_arg(ap, void *), false, 0))
+            break;
+          ++n;
+          continue;
+        }
+      if ('c' == *f)
+        {
+          if (p->cursor >= p->length)
+            break;
+          *va_arg(ap, u8 *) = s[p->cursor++];
+          ++n;
+          continue;
+        }
+
+      u32 base = ('t' == *f) ? 36 : (('x' == *f) ? 16 : 10);
+      bool minus = ('d' == *f) && (p->cursor < p->length) && ('-'
+          == s[p->cursor]);
+      u32 start = (p->cursor += minus);
+      u32 v = 0;
+
+      for (; p->cursor < p->length; ++p->cursor)
+        {
+          char c = s[p->cursor];
+          u32 d = base; // ASCII only, without the locale's ctype calls
+
+          if ((c >= '0') && (c <= '9'))
+            d = c - '0';
+          else if ((c >= 'a') && (c <= 'z'))
+            d = c - 'a' + 10;
+          else if ((c >= 'A') && (c <= 'Z'))
+            d = c - 'A' + 10;
+
+          if (d >= base)
+            break;
+          v = v * base + d;
+        }
+      if (p->cursor == start)
+        break;
+      *va_arg(ap, u32 *) = minus ? -v : v; // %d of a u32 may have printed one
+      ++n;
+    }
+  va_end(ap);
+
+  return n;
+}
+
+u32
+packetCursor(u8 * packet)
+{
+  return ((SimPacket *) packet)->cursor;
+}
+
+u8
+packetSource(u8 * packet)
+{
+  return ((SimPacket *) packet)->source;
+}
+
+void
+powerOut(u32 face, u32 on)
+{
+  current()->power.push_back((face & 0xff) | ((0 != on) << 8));
+
+  return;
+}
+
+u32
+millis()
+{
+  Board * b = current();
+
+  return b->now - b->epoch;
+}
+
+u32
+micros()
+{
+  struct timespec t;
+
+  // Handlers take no simulated time (see grid.cpp), so this is the host's
+  // clock:  the sketch only takes differences of it (REFLEX_TIMER), which
+  // then time its handlers on the host.  The histogram starts at 8 us, as
+  // fine as the SFB's micros() is assumed to tick; that's unchecked on a
+  // board, so compare the two histograms with care.
+  clock_gettime(CLOCK_MONOTONIC, &t);
+
+  return (u32) ((u64) t.tv_sec * 1000000 + t.tv_nsec / 1000);
+}
+
+void
+delay(u32 ms)
+{
+  return; // boards never block:  time only moves between events
+}
+
+void
+reenterBootloader()
+{
+  Board * b = current();
+
+  b->rebooted = true;
+  ++b->reboots;
+
+  return;
+}
@@ -0,0 +1,80 @@
+/*
+ * Title:  sfb
+ *
+ * Description:  Host stand-in for the part of the SFB/IXM runtime the
+ * suffrage sketch uses:  types, Body.reflex, Alarms, facePrintf,
+ * packetScanf, LEDs, millis, micros and the boot block ID.  The sketch compiles
+ * against it unmodified (see sketch.h);  the calls act on the board that
+ * is current on the calling thread (see sim.h).
+ */
+
+#ifndef SFB_H_GUARD
+#define SFB_H_GUARD
+
+#include <stdint.h>
+#include "SFBErrors.h"
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+#define FACE_COUNT 4 // north, east, south, west
+#define ALL_FACES 0xff // facePrintf() to every face
+#define BODY_RGB_RED_PIN 0
+#define BODY_RGB_GREEN_PIN 1
+#define BODY_RGB_BLUE_PIN 2
+
+#define B36_4(a,b,c,d) 0
+#define B36_6(a,b,c,d,e,f) 0
+
+#define API_ASSERT(cond, code) \
+  do { if (!(cond)) sfbDie(__FILE__, __LINE__, code); } while (0)
+#define API_ASSERT_NONNULL(a) API_ASSERT((a) != 0, E_API_NULL)
+#define API_ASSERT_GREATER(a, b) API_ASSERT((a) > (b), E_API_GREATER)
+#define API_ASSERT_GREATER_EQUAL(a, b) API_ASSERT((a) >= (b), E_API_GREATER_EQUAL)
+#define API_ASSERT_LESS(a, b) API_ASSERT((a) < (b), E_API_LESS)
+
+typedef void (*AlarmHandler)(u32 when);
+typedef void (*ReflexHandler)(u8 * packet);
+typedef void (*PrinterFn)(u8 face, void * arg, bool alt, int width, bool zerofill);
+typedef bool (*ScannerFn)(u8 * packet, void * arg, bool alt, int width);
+
+struct AlarmsT
+{
+  u32 create(AlarmHandler handler);
+  void set(u32 alarm, u32 when);
+  u32 currentAlarmNumber();
+};
+
+struct BodyT
+{
+  void reflex(u8 code, ReflexHandler handler);
+};
+
+extern AlarmsT Alarms;
+extern BodyT Body;
+
+void sfbDie(const char * file, int line, int code);
+u32 getBootBlockBoardId();
+void logNormal(const char * format, ...);
+void ledOn(u32 pin);
+void ledOff(u32 pin);
+bool ledIsOn(u32 pin);
+bool buttonDown();
+void facePrintf(u8 face, const char * format, ...);
+void facePrintln(u8 face, const char * format, ...);
+int packetScanf(u8 * packet, const char * format, ...);
+u32 packetCursor(u8 * packet);
+u8 packetSource(u8 * packet);
+void powerOut(u32 face, u32 on);
+u32 millis();
+u32 micros();
+void delay(u32 ms);
+void reenterBootloader();
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Title:  sim
+ *
+ * Description:  Board side of the SFB stand-in.  A Board holds everything
+ * the runtime keeps for one IXM:  its clock, alarms, reflexes, LEDs and the
+ * lines it printed.  The SFB calls in sfb.h act on simBoard, the board
+ * current on the calling thread, so several boards can run on several
+ * threads at once.  Drivers deliver packets and fire alarms through the
+ * board* functions below and collect what the board printed from sent.
+ * Times given to and taken from them are simulation times;  the board's own
+ * millis() counts from the epoch it powered on at.
+ */
+
+#ifndef SIM_H_GUARD
+#define SIM_H_GUARD
+
+#include <string>
+#include <vector>
+#include "sfb.h"
+
+const u32 ALARM_MAX = 16; // alarms a board may create
+const u8 TERMINAL_PORT = FACE_COUNT; // packet source/face of the attached terminal
+
+/* packet handed to a reflex, as packetScanf() sees it */
+struct SimPacket
+{
+  const char * text; // the whole line, reflex code first, '\n' last
+  u32 length;
+  u32 cursor; // next character packetScanf() reads
+  u8 source; // face it came in on, TERMINAL_PORT for the terminal
+};
+
+/* line printed by a board, kept in its sentText */
+struct SimLine
+{
+  u8 face; // face it goes out of, TERMINAL_PORT for the terminal
+  u32 start; // first character in sentText
+  u32 length; // '\n' included
+};
+
+struct Board
+{
+  u32 id; // boot block ID
+  u32 now; // simulation clock (ms)
+  u32 epoch; // simulation time it powered on at, millis() counts from here
+  bool off; // powered off by a neighbor
+  bool rebooted; // asked for the bootloader
+  u32 reboots; // times it asked for the bootloader
+  u32 alarmCount; // alarms created, numbered from 1
+  u32 alarmCurrent; // alarm whose handler is running
+  AlarmHandler alarmFn[ALARM_MAX + 1];
+  u32 alarmAt[ALARM_MAX + 1]; // simulation time
+  bool alarmSet[ALARM_MAX + 1];
+  ReflexHandler reflexFn[256];
+  bool led[3];
+  bool log; // pass logNormal() through to stderr
+  std::string partial[FACE_COUNT + 1]; // printed since the last '\n', per face
+  std::vector<SimLine> sent; // lines printed, until the driver takes them
+  std::string sentText; // their characters
+  std::vector<u32> power; // powerOut() calls as face | on << 8, until taken
+};
+
+extern __thread Board * simBoard; // board the SFB calls act on
+
+void boardInit(Board * board, u32 id);
+void boardEnter(Board * board, u32 now);
+bool boardDeliver(Board * board, u32 when, u8 source, const char * text,
+    u32 length);
+bool boardDeliver(Board * board, u32 when, u8 source, const std::string & text);
+std::string boardLine(const Board * board, u32 line);
+void boardTake(Board * board);
+u32 boardNextAlarm(Board * board, u32 * when);
+void boardFire(Board * board, u32 alarm);
+void boardRun(Board * board, u32 until);
+
+#endif
@@ -0,0 +1,9 @@
+/*
+ * Title:  sketch
+ *
+ * Description:  What the SFB build puts in front of a sketch:  the runtime
+ * API and the sketch's own header.  suffrage.cpp includes it as "sketch.h".
+ */
+
+#include "sfb.h"
+#include "../../suffrage.h"
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Convergence and message overhead sweep:  runs the grid simulator over every
+# combination of the lists below and prints one CSV table, the columns being
+# those of sim/grid.cpp.  Any list can be overridden from the environment,
+# e.g. SIZES="16 64" LOSSES=0 sim/sweep.sh > sweep.csv
+#
+# usage:  sweep.sh [grid binary] [board.so]
+
+GRID=${1:-build/grid}
+BOARD=${2:-build/board.so}
+SIZES=${SIZES:-"16 64 256"}
+TOPOLOGIES=${TOPOLOGIES:-"line ring grid torus"}
+CALCS=${CALCS:-"c1000 c100000 c2000000"}
+FAULTIES=${FAULTIES:-"0 1 3"}
+LOSSES=${LOSSES:-"0 1 5"}
+SEEDS=${SEEDS:-"1 2 3"}
+THREADS=${THREADS:-$(nproc 2>/dev/null || echo 1)}
+
+header=-H
+for n in $SIZES; do
+  for t in $TOPOLOGIES; do
+    for c in $CALCS; do
+      for f in $FAULTIES; do
+        for p in $LOSSES; do
+          for s in $SEEDS; do
+            "$GRID" $header -t "$t" -n "$n" -c "$c" -f "$f" -p "$p" -s "$s" \
+              -T "$THREADS" "$BOARD" 2>/dev/null || exit 1
+            header=
+          done
+        done
+      done
+    done
+  done
+done
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Forwarding cost per vote, flooding vs the spanning tree (TREE_ROUTING):
+# runs a single calculation on the same grids with both builds of the sketch
+# and prints one CSV table, per build and case:  the boards that agreed,
+# the majority, settle_p90_ms, and packets sent, records forwarded and
+# duplicates suppressed in the 10 s after the command, each in all and per
+# vote (a vote per board).  A board powered off just before the command
+# makes the tree route around it.
+#
+# usage:  tree.sh [grid binary] [flooding board.so] [tree board.so]
+
+GRID=${1:-build/grid}
+FLOOD=${2:-build/board.so}
+TREE=${3:-build/tree.so}
+CMD=${CMD:-c5000}
+JITTER=${JITTER:-3}
+SEED=${SEED:-1}
+
+echo "routing,case,boards,agreed,majority,settle_p90_ms,packets,forwarded," \
+  "suppressed,packets_per_vote,forwarded_per_vote,suppressed_per_vote" \
+  | tr -d ' '
+for so in "$FLOOD" "$TREE"; do
+  routing=flood
+  [ "$so" = "$FLOOD" ] || routing=tree
+  while read name args; do
+    "$GRID" -j "$JITTER" -s "$SEED" -c "$CMD" $args "$so" 2>/dev/null \
+      | awk -F, -v r=$routing -v c=$name '{ printf "%s,%s,%u,%u,%u,%u,%u," \
+          "%u,%u,%.1f,%.1f,%.1f\n", r, c, $2, $10, $11, $13, $22, $26, $27,
+          $22 / $2, $26 / $2, $27 / $2 }' || exit 1
+  done <<CASES
+4x4 -n 16 -w 4
+8x4 -n 32 -w 8
+8x8 -n 64 -w 8
+8x8-torus -t torus -n 64 -w 8
+8x4-off -n 32 -w 8 -k 5@9500
+CASES
+done
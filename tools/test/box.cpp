@@ -0,0 +1,140 @@
+/*
+ * Title:  box
+ *
+ * Description:  Checks the tally of a ballot box against a recount of its
+ * ballots, the way boxTally used to count them:  random ballots from a few
+ * candidates, so the lead changes hands and ties come up, cast one at a
+ * time into a box, with idle nodes evicted in between.  The grid counts as
+ * still being discovered throughout, so no majority turns final.
+ */
+
+#include "../../suffrage.cpp"
+#include "sim.h"
+
+const u32 ROUNDS = 200; // boxes filled
+const u32 CANDIDATES = 4; // distinct ballots cast
+
+Board board; // the host
+u32 seed = 1;
+
+/* xorshift32 */
+u32
+random32()
+{
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+
+  return seed;
+}
+
+/* majority of a box from its ballots, compared pairwise */
+u32
+recount(u32 b)
+{
+  u32 votes = 0, top = 0, next = 0, lead = 0;
+
+  for (u32 i = 0; i < NODE_COUNT; ++i)
+    {
+      u32 same = 0;
+
+      if (0 == BOX_VOTE_ARR[b][i])
+        continue;
+
+      ++votes;
+
+      for (u32 j = 0; j < NODE_COUNT; ++j)
+        if (BOX_VOTE_ARR[b][j] == BOX_VOTE_ARR[b][i])
+          {
+            if (j < i)
+              break; // counted the candidate already
+
+            ++same;
+          }
+
+      if (same > top)
+        {
+          next = top;
+          top = same;
+          lead = BOX_VOTE_ARR[b][i];
+        }
+
+      else if (same > next)
+        next = same;
+    }
+
+  if (votes < VOTE_COUNT_MIN)
+    return 0;
+
+  return (next == top) ? TIE : lead;
+}
+
+/* notes a check that failed */
+u32
+expect(u32 b, const char * what)
+{
+  u32 want = recount(b);
+
+  if (want == BOX_MAJORITY_ARR[b])
+    return 0;
+
+  printf("%s:  box majority %u, recount %u, %u ballots\n", what,
+      BOX_MAJORITY_ARR[b], want, BOX_VOTES_ARR[b]);
+
+  return 1;
+}
+
+int
+main()
+{
+  u32 failed = 0, checks = 0;
+  u32 now = 2000;
+
+  boardInit(&board, 1);
+  simBoard = &board;
+  setup();
+
+  for (u32 r = 0; r < ROUNDS; ++r)
+    {
+      boardEnter(&board, now += 10);
+
+      for (u32 id = 2000; NODE_COUNT < NODE_CAPACITY; id += 7)
+        log(id + r * 1000, now); // fill the node table up
+
+      HOST_CALC = 1000;
+      ++HOST_CALC_VER;
+      VER_TS = now;
+      flush();
+      boxOpen(); // an empty box for this version
+      u32 b = boxFind(HOST_CALC_VER);
+
+      for (u32 i = 0; i < NODE_COUNT; ++i)
+        {
+          u32 n = random32() % NODE_COUNT;
+
+          boxVote(b, n, 7919 + random32() % CANDIDATES);
+          failed += expect(b, "vote");
+          ++checks;
+
+          if (0 == (random32() % 8))
+            { // some nodes go idle and the longest idle one makes way
+              boardEnter(&board, now += IDLE_TIMEOUT);
+
+              for (u32 j = 1; j < NODE_COUNT; ++j)
+                if (0 != (random32() % 4))
+                  TS_HOST_ARR[j] = now;
+
+              JOIN_TS = now; // still discovering
+              nodeEvict();
+              failed += expect(b, "eviction");
+              ++checks;
+            }
+        }
+
+      boxClose(b);
+    }
+
+  printf("%u of %u failed\n", failed, checks);
+
+  return (0 == failed) ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+/*
+ * Title:  final
+ *
+ * Description:  Checks that a majority isn't declared final while the grid
+ * is still being discovered:  two boards vote one way before four more
+ * turn up and vote the other, which has to win.  Once no new board has
+ * turned up for DISCOVERY_BEATS heartbeat intervals, the majority turns
+ * final.
+ */
+
+#include "../../suffrage.cpp"
+#include "sim.h"
+
+const u32 CALC = 1000; // the n_th prime voted on
+const u32 EARLY = 7001; // ballot of the boards heard first
+const u32 LATE = 7919; // ballot of the boards heard later
+
+Board board; // the host
+
+/* hands the host a ballot from a board, for calculation version 1 */
+void
+ballot(u32 ID, u32 rslt, u32 now)
+{
+  R_PKT PKT_T;
+
+  boardEnter(&board, now);
+  PKT_T.key.ID = ID;
+  PKT_T.key.TIME = now;
+  PKT_T.calc = CALC;
+  PKT_T.calc_ver = 1;
+  PKT_T.rslt = rslt;
+  PKT_T.neighbor = 0;
+  receiveR(&PKT_T, 0, false);
+
+  return;
+}
+
+/* notes a check that failed */
+u32
+expect(bool ok, const char * what)
+{
+  if (!ok)
+    printf("%s:  majority %u, final %d, votes %u of %u nodes\n", what,
+        MAJORITY_RSLT, MAJORITY_FINAL, VOTE_COUNT, NODE_COUNT);
+
+  return ok ? 0 : 1;
+}
+
+int
+main()
+{
+  u32 failed = 0;
+
+  boardInit(&board, 1);
+  simBoard = &board;
+  setup();
+
+  // the boards' rate limits fill up from power-on, so they're heard from a
+  // while after it; the first ones agree on a lead no outstanding ballot of the
+  // nodes known so far could undo
+  ballot(2000, EARLY, 2000);
+  ballot(2007, EARLY, 2010);
+  failed += expect((EARLY == MAJORITY_RSLT) && !MAJORITY_FINAL,
+      "early lead taken for final");
+
+  // boards discovered since outvote them
+  ballot(2014, LATE, 2100);
+  ballot(2021, LATE, 2110);
+  ballot(2028, LATE, 2120);
+  ballot(2035, LATE, 2130);
+  failed += expect((LATE == MAJORITY_RSLT) && !MAJORITY_FINAL,
+      "late boards' ballots not counted");
+
+  // nobody new for a while:  only the host's ballot is still out
+  boardEnter(&board, 2130 + DISCOVERY_BEATS * BEAT_STABLE);
+  finalCheck();
+  failed += expect((LATE == MAJORITY_RSLT) && MAJORITY_FINAL,
+      "settled grid not final");
+
+  printf("%u of 3 failed\n", failed);
+
+  return (0 == failed) ? 0 : 1;
+}
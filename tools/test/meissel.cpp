@@ -0,0 +1,208 @@
+/*
+ * Title:  meissel
+ *
+ * Description:  Checks the n_th primes past the segmented range and the
+ * prime counts past the checkpoints, both worked out with Meissel's formula
+ * (see lehmerStep), against a plain sieve of Eratosthenes run up to the
+ * largest of them.  The n are drawn at random from PRIME_SEGMENTED_THRESHOLD
+ * to PRIME_LEHMER_THRESHOLD and the bounds up to 2^32 - 1, along with the
+ * edges of the range.
+ *
+ * Usage:  meissel [samples [seed]]   (8 of each, seed 1)
+ */
+
+#include "../../suffrage.cpp"
+#include <algorithm>
+#include <vector>
+
+const u32 SIEVE_SPAN = 1 << 19; // integers the plain sieve covers per segment
+
+/* a request to the plain sieve:  the n_th prime, or the primes up to x */
+struct Query
+{
+  bool count; // true for the primes up to arg, false for the arg_th prime
+  u32 arg;
+  u32 want; // the sieve's answer
+};
+
+u32 seedState = 1;
+
+u32
+random32()
+{
+  seedState ^= seedState << 13;
+  seedState ^= seedState >> 17;
+  seedState ^= seedState << 5;
+
+  return seedState;
+}
+
+/*
+ * Answers the queries with a plain segmented sieve of Eratosthenes over the
+ * odd integers from 0 to the largest bound they need.
+ */
+void
+plainSieve(std::vector<Query> & queries)
+{
+  std::vector<u32> base; // odd primes up to 2^16, and the next odd multiple
+  std::vector<u64> next; // of each to cross off
+  std::vector<bool> small(65536, true);
+
+  for (u32 p = 3; p < 65536; p += 2)
+    if (small[p])
+      {
+        base.push_back(p);
+        next.push_back((u64) p * p);
+
+        for (u32 k = p * p; k < 65536; k += p)
+          small[k] = false;
+      }
+
+  u64 end = 0;
+
+  for (u32 i = 0; i < queries.size(); ++i)
+    end = std::max(end, queries[i].count ? (u64) queries[i].arg + 1
+        : (u64) 1 << 32);
+
+  std::vector<u8> composite(SIEVE_SPAN / 2); // one byte per odd integer
+  u32 primes = 1; // 2 is the only even prime
+
+  for (u64 low = 0; low < end; low += SIEVE_SPAN)
+    {
+      std::fill(composite.begin(), composite.end(), 0);
+      u64 high = low + SIEVE_SPAN;
+
+      if (0 == low)
+        composite[0] = 1; // 1 isn't prime
+
+      for (u32 i = 0; (i < base.size()) && (next[i] < high); ++i)
+        {
+          u64 k = next[i];
+
+          for (; k < high; k += 2 * base[i])
+            composite[(k - low) >> 1] = 1;
+
+          next[i] = k;
+        }
+
+      u32 before = primes;
+
+      for (u32 j = 0; j < SIEVE_SPAN / 2; ++j)
+        primes += composite[j] ^ 1;
+
+      for (u32 i = 0; i < queries.size(); ++i)
+        {
+          Query * r = &queries[i];
+
+          if (r->count ? ((r->arg < low) || (r->arg >= high)) : ((r->arg
+              <= before) || (r->arg > primes)))
+            continue; // answered in another segment
+
+          u32 c = before;
+          u32 j = 0;
+
+          for (; r->count ? ((low + 2 * j + 1) <= r->arg) : (c < r->arg); ++j)
+            c += composite[j] ^ 1;
+
+          r->want = r->count ? c : (u32) (low + 2 * j - 1);
+        }
+    }
+
+  return;
+}
+
+/* runs a workload step the way calcSlice does, until it's done */
+u32
+run(bool (*step)(u32, u32 *), u32 arg)
+{
+  u32 rslt;
+
+  JOB_POS = 0;
+  JOB_ACC = 0;
+  LEHMER_PHASE = 0;
+
+  while (!step(arg, &rslt))
+    ;
+
+  return rslt;
+}
+
+int
+main(int argc, char ** argv)
+{
+  u32 samples = (argc > 1) ? atoi(argv[1]) : 8;
+  seedState = (argc > 2) ? atoi(argv[2]) : 1;
+
+  std::vector<Query> queries;
+  Query q;
+  q.want = 0;
+
+  q.count = false; // the n_th primes
+  q.arg = PRIME_SEGMENTED_THRESHOLD + 1;
+  queries.push_back(q);
+  q.arg = PRIME_LEHMER_THRESHOLD - 1;
+  queries.push_back(q);
+  q.arg = PRIME_LEHMER_THRESHOLD;
+  queries.push_back(q);
+
+  for (u32 i = 0; i < samples; ++i)
+    {
+      q.arg = PRIME_SEGMENTED_THRESHOLD + 1 + random32()
+          % (PRIME_LEHMER_THRESHOLD - PRIME_SEGMENTED_THRESHOLD);
+      queries.push_back(q);
+    }
+
+  q.count = true; // the primes up to x
+  q.arg = 0xffffffff;
+  queries.push_back(q);
+
+  for (u32 i = 0; i < samples; ++i)
+    {
+      q.arg = PI_STRIDE + random32() % (0xffffffff - PI_STRIDE);
+      queries.push_back(q);
+    }
+
+  plainSieve(queries);
+  setup();
+
+  u32 failed = 0;
+
+  for (u32 i = 0; i < queries.size(); ++i)
+    {
+      u32 got = queries[i].count ? run(lehmerStep, queries[i].arg)
+          : run(primeStep, queries[i].arg);
+
+      printf("%s(%u) = %u", queries[i].count ? "pi" : "p", queries[i].arg, got);
+
+      if (got != queries[i].want)
+        {
+          printf(", the sieve says %u", queries[i].want);
+          ++failed;
+        }
+
+      printf("\n");
+    }
+
+  // the edges of the range, and what a FAULTY board asks for past it
+  if ((4294967279u != run(primeStep, PRIME_LEHMER_THRESHOLD - 1))
+      || (4294967291u != run(primeStep, PRIME_LEHMER_THRESHOLD))
+      || (0 != run(primeStep, PRIME_LEHMER_THRESHOLD + 1)))
+    {
+      printf("the edges of the range are off\n");
+      ++failed;
+    }
+
+  FAULTY = true;
+  calculate(PRIME_LEHMER_THRESHOLD, 1);
+  JOB_CALC = 0; // the target is all that's wanted
+
+  if (PRIME_LEHMER_THRESHOLD - 1 != JOB_TARGET)
+    {
+      printf("a FAULTY board asks for the %u_th prime\n", JOB_TARGET);
+      ++failed;
+    }
+
+  printf("%u of %u failed\n", failed, (u32) queries.size() + 2);
+
+  return (0 == failed) ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+/*
+ * Title:  table
+ *
+ * Description:  Checks every entry of the compile-time prime table
+ * (PRIME_TABLE) against the sieve's nthPrime(), and that calculate() answers
+ * the primes in it straight from the table.
+ */
+
+#define PRIME_TABLE 1
+#include "../../suffrage.cpp"
+
+int
+main()
+{
+  setup();
+  sieveExtend(PRIME_ARR_THRESHOLD);
+
+  u32 failed = 0;
+
+  for (u32 n = 1; n <= PRIME_TABLE_SIZE; ++n)
+    if (PRIME_TABLE_ARR[n - 1] != nthPrime(n))
+      {
+        printf("PRIME_TABLE_ARR[%u] = %u, nthPrime(%u) = %u\n", n - 1,
+            PRIME_TABLE_ARR[n - 1], n, nthPrime(n));
+        ++failed;
+      }
+
+  // the edges of the table, answered without running a job
+  u32 edges[] =
+    { 1, PRIME_TABLE_SIZE };
+
+  for (u32 i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i)
+    {
+      flush(); // a new voting session, as for a new (c)alculation
+      HOST_CALC = edges[i];
+      HOST_CALC_VER = i + 1;
+      calculate(HOST_CALC, HOST_CALC_VER);
+
+      if ((0 != JOB_CALC) || (nthPrime(edges[i]) != VOTE_NODE_ARR[0]))
+        {
+          printf("calculate(%u) voted %u\n", edges[i], VOTE_NODE_ARR[0]);
+          ++failed;
+        }
+    }
+
+  printf("%u of %u failed\n", failed, PRIME_TABLE_SIZE + 2);
+
+  return (0 == failed) ? 0 : 1;
+}
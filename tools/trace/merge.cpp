@@ -0,0 +1,237 @@
+/*
+ * Title:  merge
+ *
+ * Description:  Merges the trace dumps of several boards into one timeline.
+ * A (d)rain packet makes a board print the trace events it recorded as "D"
+ * lines of CSV (see d_handler):  its ID, its millis() at the event, the
+ * event (TRACE_*), a board ID and a value.  Each dump starts with a "now"
+ * line carrying the board's millis() at the drain, and the boards' clocks
+ * count from when each of them powered on.  If every board is drained at
+ * the same moment, the event at t on a board drained at now happened
+ * now - t before the drain, which lines them all up.
+ *
+ * The events are printed oldest first as CSV:  time on the clock of the
+ * board whose dump comes first, board, event, its name, board ID and value.
+ * Boards whose ring buffer went round before the drain lose their oldest
+ * events;  how many is printed to stderr.
+ *
+ * The input is the terminal output of the boards, from the files given or
+ * stdin.  Lines that aren't trace lines are skipped, and "N:" prefixes such
+ * as those of grid -o are taken off, so the dumps of a whole grid come
+ * straight from:
+ *
+ *   build/grid -c c1000 -r d -o trace.txt build/board.so
+ *   build/merge trace.txt
+ *
+ * Usage:  merge [-H] [file ...]
+ *  -H          print the CSV header first
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef unsigned int u32;
+typedef int s32;
+
+const u32 LINE_MAX = 256; // longest line read
+
+/* event of a trace dump, as its board printed it */
+struct Event
+{
+  std::string board; // ID of the board that recorded it
+  u32 time; // that board's millis() at the event
+  char kind; // TRACE_*
+  std::string id; // board ID the event is about
+  std::string value;
+  s32 at; // time relative to the drain of its dump
+};
+
+/* the last drain of each board:  its millis() at the drain, events lost */
+struct Drain
+{
+  u32 now;
+  u32 lost;
+};
+
+bool
+earlier(const Event & a, const Event & b)
+{
+  return a.at < b.at; // equal times stay in input order (stable_sort)
+}
+
+/* name of a trace event, as listed with the TRACE_* kinds */
+const char *
+kindName(char kind)
+{
+  switch (kind)
+    {
+  case 'r':
+    return "received";
+  case 'f':
+    return "forwarded";
+  case 'd':
+    return "duplicate";
+  case 'v':
+    return "vote";
+  case 'm':
+    return "majority";
+  case 's':
+    return "strike";
+  case 'x':
+    return "reboot";
+  case 'o':
+    return "retired";
+  case 'q':
+    return "final";
+    }
+
+  return "?";
+}
+
+/*
+ * Splits a trace line into its comma separated fields, after the "D" and
+ * any "N:" prefix.  Returns false if it isn't a trace line.
+ */
+bool
+fields(const char * line, std::vector<std::string> * out)
+{
+  const char * colon = strchr(line, ':');
+
+  if (colon && (colon < strchr(line, ',')))
+    line = colon + 1;
+
+  if ('D' != *line)
+    return false;
+
+  out->clear();
+  std::string field;
+
+  for (const char * c = line + 1; *c && ('\n' != *c) && ('\r' != *c); ++c)
+    if (',' == *c)
+      {
+        out->push_back(field);
+        field.clear();
+      }
+    else
+      field += *c;
+
+  out->push_back(field);
+
+  return ((4 == out->size()) && ("now" == (*out)[2])) || (5 == out->size());
+}
+
+/*
+ * Reads the trace lines of a file.  An event takes the drain of the "now"
+ * line before it on its board, so a board drained several times has each
+ * of its dumps lined up by its own drain.
+ */
+void
+read(FILE * in, std::vector<Event> * events, std::vector<std::string> * boards,
+    std::map<std::string, Drain> * drains)
+{
+  char line[LINE_MAX];
+  std::vector<std::string> f;
+
+  while (fgets(line, sizeof(line), in))
+    {
+      if (!fields(line, &f))
+        continue;
+
+      if ("now" == f[2])
+        {
+          if (drains->find(f[0]) == drains->end())
+            boards->push_back(f[0]);
+
+          Drain & d = (*drains)[f[0]];
+          d.now = strtoul(f[1].c_str(), 0, 10);
+          d.lost = strtoul(f[3].c_str(), 0, 10);
+
+          if (0 != d.lost)
+            fprintf(stderr, "merge:  board %s lost %u events\n", f[0].c_str(),
+                d.lost);
+
+          continue;
+        }
+
+      std::map<std::string, Drain>::iterator d = drains->find(f[0]);
+
+      if (d == drains->end())
+        continue; // no drain to line it up by
+
+      Event e;
+      e.board = f[0];
+      e.time = strtoul(f[1].c_str(), 0, 10);
+      e.kind = f[2].empty() ? '?' : f[2][0];
+      e.id = f[3];
+      e.value = f[4];
+      e.at = (s32) (e.time - d->second.now); // before the drain, so <= 0
+      events->push_back(e);
+    }
+
+  return;
+}
+
+int
+main(int argc, char ** argv)
+{
+  bool header = false;
+  int opt;
+
+  while (-1 != (opt = getopt(argc, argv, "H")))
+    switch (opt)
+      {
+    case 'H':
+      header = true;
+      break;
+    default:
+      fprintf(stderr, "usage:  merge [-H] [file ...] (see merge.cpp)\n");
+      return 2;
+      }
+
+  std::vector<Event> events;
+  std::vector<std::string> boards; // in the order their dumps came
+  std::map<std::string, Drain> drains;
+
+  if (optind >= argc)
+    read(stdin, &events, &boards, &drains);
+
+  for (int i = optind; i < argc; ++i)
+    {
+      FILE * in = fopen(argv[i], "r");
+
+      if (!in)
+        {
+          perror(argv[i]);
+          return 1;
+        }
+
+      read(in, &events, &boards, &drains);
+      fclose(in);
+    }
+
+  if (boards.empty())
+    {
+      fprintf(stderr, "merge:  no trace dumps in the input\n");
+      return 1;
+    }
+
+  std::stable_sort(events.begin(), events.end(), earlier);
+
+  u32 clock = drains[boards[0]].now; // the common clock is the first board's
+
+  if (header)
+    printf("time_ms,board,event,name,id,value\n");
+
+  for (u32 i = 0; i < events.size(); ++i)
+    printf("%u,%s,%c,%s,%s,%s\n", clock + events[i].at,
+        events[i].board.c_str(), events[i].kind, kindName(events[i].kind),
+        events[i].id.c_str(), events[i].value.c_str());
+
+  return 0;
+}